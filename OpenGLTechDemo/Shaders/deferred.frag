@@ -0,0 +1,48 @@
+#version 330 core
+
+// Lighting pass of the deferred path: shades every pixel of the G-buffer once, with the same
+// permutations of include/lights.glsl as the forward shaders. With CLUSTERED each pixel only
+// loops over the lights of its cluster, so this is tiled light accumulation.
+
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+// the material of the pixel, read from the G-buffer before CalcLighting() runs
+float gShininess;
+float gBlinnScale;
+#define MATERIAL_SHININESS gShininess
+#define DIR_LIGHT_BLINN_SCALE gBlinnScale
+
+#include "include/frame.glsl"
+#include "include/lights.glsl"
+#include "include/shadows.glsl"
+#include "include/gbuffer.glsl"
+
+uniform sampler2D gAlbedoShininess;
+uniform sampler2D gNormal;
+uniform sampler2D gDepth;
+
+void main()
+{
+	float depth = texelFetch(gDepth, ivec2(gl_FragCoord.xy), 0).r;
+	// nothing was drawn here, leave the clear color for the skybox
+	if (depth == 1.0)
+		discard;
+
+	vec4 albedoShininess = texelFetch(gAlbedoShininess, ivec2(gl_FragCoord.xy), 0);
+	vec4 normalBlinnScale = texelFetch(gNormal, ivec2(gl_FragCoord.xy), 0);
+	gShininess = DecodeShininess(albedoShininess.a);
+	gBlinnScale = DecodeBlinnScale(normalBlinnScale.a);
+
+	vec3 fragPos = GBufferPosition(TexCoords, depth);
+	vec3 norm = DecodeNormal(normalBlinnScale.xy);
+	vec3 viewDir = normalize(viewPos - fragPos);
+
+	float shadow = ShadowCalculation(fragPos, norm);
+	vec3 finalColor = CalcLighting(norm, fragPos, viewDir, shadow);
+
+	FragColor = vec4(albedoShininess.rgb * finalColor, 1.0);
+	// the forward passes after this one depth test against the G-buffer's depth
+	gl_FragDepth = depth;
+}
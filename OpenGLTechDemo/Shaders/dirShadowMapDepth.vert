@@ -2,10 +2,13 @@
 
 layout (location = 0) in vec3 aPos;
 
-uniform mat4 lightSpaceMatrix;
 uniform mat4 model;
+// layer of the shadow map texture array being rendered
+uniform int cascade;
+
+#include "include/frame.glsl"
 
 void main()
 {
-    gl_Position = lightSpaceMatrix * model * vec4(aPos, 1.0);
+    gl_Position = cascadeMatrices[cascade] * model * vec4(aPos, 1.0);
 }
\ No newline at end of file
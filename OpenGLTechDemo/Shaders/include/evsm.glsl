@@ -0,0 +1,46 @@
+// Exponential variance shadow maps: the moments of the warped depth that ShadowMoments prefilters,
+// and the visibility of a receiver against their filtered values.
+// The depth is moved to [-1, 1] before the warp so both exponents use their whole range, the
+// exponents keep e^(2c) inside 32 bit floats.
+
+#define EVSM_POSITIVE_EXPONENT 40.0
+#define EVSM_NEGATIVE_EXPONENT 5.0
+// raising the visibility's floor cuts the light that bleeds through overlapping casters
+#define EVSM_BLEEDING_REDUCTION 0.3
+// minimum variance, in units of the squared warped depth, against acne on flat receivers
+#define EVSM_MIN_VARIANCE 0.0001
+
+vec2 WarpDepth(float depth)
+{
+	depth = 2.0 * depth - 1.0;
+	return vec2(exp(EVSM_POSITIVE_EXPONENT * depth), -exp(-EVSM_NEGATIVE_EXPONENT * depth));
+}
+
+vec4 ShadowMomentsOf(float depth)
+{
+	vec2 warped = WarpDepth(depth);
+	return vec4(warped.x, warped.x * warped.x, warped.y, warped.y * warped.y);
+}
+
+// upper bound of the lit fraction from the mean and the mean square of the warped depth
+float chebyshevUpperBound(vec2 moments, float depth, float minVariance)
+{
+	if (depth <= moments.x)
+		return 1.0;
+	float variance = max(moments.y - moments.x * moments.x, minVariance);
+	float distance = depth - moments.x;
+	float lit = variance / (variance + distance * distance);
+	return clamp((lit - EVSM_BLEEDING_REDUCTION) / (1.0 - EVSM_BLEEDING_REDUCTION), 0.0, 1.0);
+}
+
+// fraction of light reaching a receiver at depth, from the filtered moments
+float MomentsLit(vec4 moments, float depth)
+{
+	vec2 warped = WarpDepth(depth);
+	// the variance floor scales with the derivative of each warp
+	vec2 minVariance = EVSM_MIN_VARIANCE * vec2(EVSM_POSITIVE_EXPONENT, EVSM_NEGATIVE_EXPONENT) * abs(warped);
+	minVariance *= minVariance;
+	float positive = chebyshevUpperBound(moments.xy, warped.x, minVariance.x);
+	float negative = chebyshevUpperBound(moments.zw, warped.y, minVariance.y);
+	return min(positive, negative);
+}
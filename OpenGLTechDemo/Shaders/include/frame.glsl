@@ -0,0 +1,13 @@
+// camera and shadow matrices, filled once per frame by FrameUniformBuffer
+#define MAX_SHADOW_CASCADES 4
+
+layout (std140) uniform FrameUniforms {
+	mat4 projection;
+	mat4 view;
+	// light view-projection of every shadow cascade and the view depth each one ends at, see ShadowCascades
+	mat4 cascadeMatrices[MAX_SHADOW_CASCADES];
+	vec4 cascadeSplits;
+	vec3 viewPos;
+	// tile size in pixels, scale and bias of the depth slices, see ClusteredLights
+	vec4 clusterParams;
+};
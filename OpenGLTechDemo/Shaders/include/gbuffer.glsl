@@ -0,0 +1,56 @@
+// Packing of the G-buffer written by the GBUFFER permutation of the lit shaders and read by
+// deferred.frag. Two RGBA targets of 32 bits each plus the depth buffer:
+//   0 RGBA8		albedo, log2 of the shininess / 10
+//   1 RGB10_A2		octahedral normal, unused, DIR_LIGHT_BLINN_SCALE as log4 / 3
+// The position is reconstructed from depth, see GBufferPosition().
+
+// octahedral mapping of a unit vector to [0,1]^2
+vec2 EncodeNormal(vec3 n)
+{
+	n /= abs(n.x) + abs(n.y) + abs(n.z);
+	vec2 e = n.xy;
+	if (n.z < 0.0)
+		e = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+	return e * 0.5 + 0.5;
+}
+
+vec3 DecodeNormal(vec2 e)
+{
+	e = e * 2.0 - 1.0;
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0);
+	n.x += n.x >= 0.0 ? -t : t;
+	n.y += n.y >= 0.0 ? -t : t;
+	return normalize(n);
+}
+
+vec4 EncodeAlbedoShininess(vec3 albedo, float shininess)
+{
+	return vec4(albedo, clamp(log2(max(shininess, 1.0)) / 10.0, 0.0, 1.0));
+}
+
+float DecodeShininess(float encoded)
+{
+	return exp2(encoded * 10.0);
+}
+
+// blinnScale is 1, 4, 16 or 64
+vec4 EncodeNormalBlinnScale(vec3 normal, float blinnScale)
+{
+	return vec4(EncodeNormal(normal), 0.0, log2(blinnScale) / 6.0);
+}
+
+float DecodeBlinnScale(float encoded)
+{
+	return exp2(floor(encoded * 3.0 + 0.5) * 2.0);
+}
+
+// world-space position of a depth buffer sample, projection must be a symmetric perspective
+vec3 GBufferPosition(vec2 texCoords, float depth)
+{
+	vec3 ndc = vec3(texCoords, depth) * 2.0 - 1.0;
+	float viewZ = -projection[3][2] / (ndc.z + projection[2][2]);
+	vec3 viewPosition = vec3(ndc.x * -viewZ / projection[0][0], ndc.y * -viewZ / projection[1][1], viewZ);
+	// view is a rotation and a translation, so its inverse is the transposed rotation
+	return transpose(mat3(view)) * (viewPosition - view[3].xyz);
+}
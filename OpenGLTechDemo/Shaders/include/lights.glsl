@@ -0,0 +1,322 @@
+// Lights of the scene and their Phong / Blinn-Phong shading, shared by the lit shaders.
+// Compile-time switches, injected by ShaderPermutations:
+//   BLINN_PHONG		Blinn-Phong highlights instead of Phong
+//   NR_POINT_LIGHTS	point lights shaded at most per draw, up to MAX_POINT_LIGHTS
+//   NR_SPOT_LIGHTS		spot lights shaded at most per draw, up to MAX_SPOT_LIGHTS
+//   CLUSTERED			point and spot lights come from the clustered light lists instead of the
+//						Lights block, NR_POINT_LIGHTS and NR_SPOT_LIGHTS are ignored
+//   POINT_SHADOWS		the point lights of the Lights block cast shadows from their tiles in the
+//						shadow atlas
+// DIR_LIGHT_BLINN_SCALE scales the shininess of the directional light's Blinn-Phong highlight.
+// MATERIAL_SHININESS is the shininess expression, deferred.frag reads it from the G-buffer.
+
+// slots of the Lights block, must match LightBlockStd140
+#define MAX_POINT_LIGHTS 4
+#define MAX_SPOT_LIGHTS 1
+
+#ifndef NR_POINT_LIGHTS
+#define NR_POINT_LIGHTS MAX_POINT_LIGHTS
+#endif
+#ifndef NR_SPOT_LIGHTS
+#define NR_SPOT_LIGHTS MAX_SPOT_LIGHTS
+#endif
+#ifndef DIR_LIGHT_BLINN_SCALE
+#define DIR_LIGHT_BLINN_SCALE 1.0
+#endif
+#ifndef MATERIAL_SHININESS
+#define MATERIAL_SHININESS material.shininess
+#endif
+
+// point lights with shadows in the atlas, must match PointShadows
+#define MAX_POINT_SHADOWS 4
+
+// froxel grid, must match ClusteredLights
+#define CLUSTER_GRID_X 16
+#define CLUSTER_GRID_Y 9
+#define CLUSTER_GRID_Z 24
+
+struct Material {	
+	float specularIntensity;
+    float shininess;
+}; 
+
+struct Light
+{
+	vec3 color;
+	vec3 ambient;
+	vec3 diffuse;
+	vec3 specular;
+};
+
+struct DirLight {
+	Light base;
+
+    vec3 direction;
+};
+
+struct PointLight {
+	Light base;
+
+    vec3 position;
+
+    float constant;
+    float linear;
+    float quadratic;
+};
+
+struct SpotLight {
+	PointLight base;
+
+    vec3 direction;
+    float cutOff;
+    float outerCutOff;     
+};
+
+// filled by LightManager, which only uploads the lights that changed
+layout (std140) uniform Lights {
+	DirLight dirLight;
+	PointLight pointLights[MAX_POINT_LIGHTS];
+	SpotLight spotLights[MAX_SPOT_LIGHTS];
+};
+uniform Material material;
+
+#ifndef CLUSTERED
+// the lights of the block whose range reaches the object drawn, see LightManager::CullBlockLights
+uniform int drawPointLightCount;
+uniform int drawPointLights[MAX_POINT_LIGHTS];
+uniform int drawSpotLightCount;
+uniform int drawSpotLights[MAX_SPOT_LIGHTS];
+#endif
+
+#ifdef CLUSTERED
+// every light of the LightManager, 5 texels each
+uniform samplerBuffer clusterLightData;
+// offset and count of the light list of every cluster
+uniform usamplerBuffer clusterGrid;
+uniform usamplerBuffer clusterLightIndices;
+#endif
+
+#ifdef POINT_SHADOWS
+// shadows of every pointLights slot of the Lights block, distance to the light over its far
+// plane, in six tiles of the atlas per light, see PointShadows::TileRect
+uniform sampler2DShadow pointShadowAtlas;
+uniform vec4 pointShadowTiles[MAX_POINT_SHADOWS * 6];
+uniform float pointShadowFarPlanes[MAX_POINT_SHADOWS];
+#ifdef CLUSTERED
+// id of the light in the light texture every shadow belongs to, -1 for none
+uniform int pointShadowLights[MAX_POINT_SHADOWS];
+#endif
+
+// right and up vector of every face's view, in the order of GL_TEXTURE_CUBE_MAP_POSITIVE_X and on
+const vec3 shadowFaceRights[6] = vec3[](
+	vec3(0.0, 0.0, -1.0), vec3(0.0, 0.0, 1.0),
+	vec3(1.0, 0.0, 0.0), vec3(1.0, 0.0, 0.0),
+	vec3(1.0, 0.0, 0.0), vec3(-1.0, 0.0, 0.0)
+);
+const vec3 shadowFaceUps[6] = vec3[](
+	vec3(0.0, -1.0, 0.0), vec3(0.0, -1.0, 0.0),
+	vec3(0.0, 0.0, 1.0), vec3(0.0, 0.0, -1.0),
+	vec3(0.0, -1.0, 0.0), vec3(0.0, -1.0, 0.0)
+);
+#endif
+
+// shadow term of a point light, shadow is its slot in the atlas or -1, 1.0 in full shadow
+float PointShadowCalculation(int shadow, vec3 fragPos, vec3 lightPosition)
+{
+#ifdef POINT_SHADOWS
+	if (shadow < 0)
+		return 0.0;
+
+	// the face of the major axis, as a cube map lookup would pick it
+	vec3 fragToLight = fragPos - lightPosition;
+	vec3 axes = abs(fragToLight);
+	int face;
+	if (axes.x >= axes.y && axes.x >= axes.z)
+		face = fragToLight.x > 0.0 ? 0 : 1;
+	else if (axes.y >= axes.z)
+		face = fragToLight.y > 0.0 ? 2 : 3;
+	else
+		face = fragToLight.z > 0.0 ? 4 : 5;
+
+	vec4 tile = pointShadowTiles[shadow * 6 + face];
+	// the atlas had no room for the light
+	if (tile.z <= 0.0)
+		return 0.0;
+
+	// projection of the 90 degree frustum of the face, kept half a texel inside the tile so the
+	// bilinear compare doesn't reach into its neighbours
+	float major = max(axes.x, max(axes.y, axes.z));
+	vec2 faceCoords = vec2(dot(fragToLight, shadowFaceRights[face]), dot(fragToLight, shadowFaceUps[face])) / major * 0.5 + 0.5;
+	float halfTexel = 0.5 / (tile.z * float(textureSize(pointShadowAtlas, 0).x));
+	faceCoords = clamp(faceCoords, halfTexel, 1.0 - halfTexel);
+
+	float reference = (length(fragToLight) - 0.05) / pointShadowFarPlanes[shadow];
+	return 1.0 - texture(pointShadowAtlas, vec3(tile.xy + faceCoords * tile.z, reference));
+#else
+	return 0.0;
+#endif
+}
+
+// specular factor, blinnScale multiplies the shininess of the Blinn-Phong highlight
+float CalcSpecular(vec3 lightDir, vec3 normal, vec3 viewDir, float blinnScale)
+{
+#ifdef BLINN_PHONG
+	vec3 halfwayDir = normalize(lightDir + viewDir);
+	return pow(max(dot(normal, halfwayDir), 0.0), MATERIAL_SHININESS * blinnScale);
+#else
+	vec3 reflectDir = reflect(-lightDir, normal);
+	return pow(max(dot(viewDir, reflectDir), 0.0), MATERIAL_SHININESS);
+#endif
+}
+
+// calculates the color when using the directional light, shadow is 1.0 in full shadow
+vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir, float shadow)
+{
+    vec3 lightDir = normalize(-light.direction);
+
+    // diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+
+    // specular shading
+	float spec = CalcSpecular(lightDir, normal, viewDir, DIR_LIGHT_BLINN_SCALE);
+
+    // combine results
+    vec3 ambient = light.base.ambient;
+    vec3 diffuse = light.base.diffuse * diff;
+    vec3 specular = light.base.specular * spec;
+
+	vec3 lighting = (ambient + (1.0 - shadow) * (diffuse + specular));
+
+	return lighting * light.base.color;
+}
+
+// calculates the color when using a point light, shadow is 1.0 in full shadow
+vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir, float shadow)
+{
+    vec3 lightDir = normalize(light.position - fragPos);
+
+    // diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+
+    // specular shading
+	float spec = CalcSpecular(lightDir, normal, viewDir, 4.0);
+
+	// attenuation
+    float distance = length(light.position - fragPos);
+    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));    
+
+	// combine results
+    vec3 ambient = light.base.ambient;
+    vec3 diffuse = light.base.diffuse * diff;
+    vec3 specular = light.base.specular * spec;
+
+	ambient *= attenuation;
+    diffuse *= attenuation;
+    specular *= attenuation;
+
+	return (ambient + (1.0 - shadow) * (diffuse + specular)) * light.base.color;
+}
+
+// calculates the color when using a spot light.
+vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+    vec3 lightDir = normalize(light.base.position - fragPos);
+
+	// diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+
+	// specular shading
+	float spec = CalcSpecular(lightDir, normal, viewDir, 4.0);
+
+	// attenuation
+    float distance = length(light.base.position - fragPos);
+    float attenuation = 1.0 / (light.base.constant + light.base.linear * distance + light.base.quadratic * (distance * distance));    
+
+	// spotlight intensity
+    float theta = dot(lightDir, normalize(-light.direction)); 
+    float epsilon = light.cutOff - light.outerCutOff;
+    float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+
+	// combine results
+    vec3 ambient = light.base.base.ambient;
+    vec3 diffuse = light.base.base.diffuse * diff;
+    vec3 specular = light.base.base.specular * spec;
+
+	ambient *= attenuation * intensity;
+    diffuse *= attenuation * intensity;
+    specular *= attenuation * intensity;
+
+	return (ambient + diffuse + specular) * light.base.base.color;
+}
+
+#ifdef CLUSTERED
+// CalcSpotLight for a light of the light texture, whose colors are premultiplied by the light
+// color. Point lights have a cone that includes every direction.
+vec3 CalcClusterLight(int light, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+	// only the lights of the Lights block have shadows
+	int shadow = -1;
+#ifdef POINT_SHADOWS
+	for (int i = 0; i < MAX_POINT_SHADOWS; i++)
+		if (pointShadowLights[i] == light)
+			shadow = i;
+#endif
+
+	vec4 positionConstant = texelFetch(clusterLightData, light * 5);
+	vec4 ambientLinear = texelFetch(clusterLightData, light * 5 + 1);
+	vec4 diffuseQuadratic = texelFetch(clusterLightData, light * 5 + 2);
+	vec4 specularCutOff = texelFetch(clusterLightData, light * 5 + 3);
+	vec4 directionOuterCutOff = texelFetch(clusterLightData, light * 5 + 4);
+
+    vec3 lightDir = normalize(positionConstant.xyz - fragPos);
+
+	// diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+
+	// specular shading
+	float spec = CalcSpecular(lightDir, normal, viewDir, 4.0);
+
+	// attenuation
+    float distance = length(positionConstant.xyz - fragPos);
+    float attenuation = 1.0 / (positionConstant.w + ambientLinear.w * distance + diffuseQuadratic.w * (distance * distance));
+
+	// spotlight intensity
+    float theta = dot(lightDir, normalize(-directionOuterCutOff.xyz));
+    float epsilon = specularCutOff.w - directionOuterCutOff.w;
+    float intensity = clamp((theta - directionOuterCutOff.w) / epsilon, 0.0, 1.0);
+
+	float lit = 1.0 - PointShadowCalculation(shadow, fragPos, positionConstant.xyz);
+
+	return (ambientLinear.rgb + lit * (diffuseQuadratic.rgb * diff + specularCutOff.rgb * spec)) * attenuation * intensity;
+}
+#endif
+
+// sum of every light at the fragment, shadow is the directional light's shadow term
+vec3 CalcLighting(vec3 normal, vec3 fragPos, vec3 viewDir, float shadow)
+{
+    // phase 1: directional lighting
+    vec3 finalColor = CalcDirLight(dirLight, normal, viewDir, shadow);
+
+#ifdef CLUSTERED
+	// phase 2: the point and spot lights binned into the fragment's cluster
+	float depth = -(view * vec4(fragPos, 1.0)).z;
+	ivec3 cluster = ivec3(ivec2(gl_FragCoord.xy / clusterParams.xy), int(floor(log(depth) * clusterParams.z + clusterParams.w)));
+	cluster = clamp(cluster, ivec3(0), ivec3(CLUSTER_GRID_X - 1, CLUSTER_GRID_Y - 1, CLUSTER_GRID_Z - 1));
+	uvec2 list = texelFetch(clusterGrid, cluster.x + CLUSTER_GRID_X * (cluster.y + CLUSTER_GRID_Y * cluster.z)).xy;
+	for (uint i = 0u; i < list.y; i++)
+		finalColor += CalcClusterLight(int(texelFetch(clusterLightIndices, int(list.x + i)).r), normal, fragPos, viewDir);
+#else
+    // phase 2: point lights
+    for(int i = 0; i < min(drawPointLightCount, NR_POINT_LIGHTS); i++) {
+		int slot = drawPointLights[i];
+		float pointShadow = PointShadowCalculation(slot, fragPos, pointLights[slot].position);
+        finalColor += CalcPointLight(pointLights[slot], normal, fragPos, viewDir, pointShadow);
+	}
+
+    // phase 3: spot light
+	for(int i = 0; i < min(drawSpotLightCount, NR_SPOT_LIGHTS); i++)
+		finalColor += CalcSpotLight(spotLights[drawSpotLights[i]], normal, fragPos, viewDir);  
+#endif
+
+	return finalColor;
+}
@@ -0,0 +1,143 @@
+// Shadow term of the directional light, from the cascaded depth maps of the shadow pass.
+// Needs include/frame.glsl for the cascade matrices and splits, and gl_FragCoord, so it is only
+// included by fragment shaders.
+// The depth array has GL_TEXTURE_COMPARE_MODE and linear filtering, so every tap is a hardware
+// depth compare of the 2x2 texels around it, blended bilinearly.
+// Compile-time switches, injected by ShaderPermutations:
+//   SHADOWS			sample the shadow map, without it nothing is in shadow
+//   SHADOW_FILTER		SHADOW_FILTER_BOX to SHADOW_FILTER_EVSM, see ShadowFilters in ShaderPermutations.h
+//   PCF_KERNEL			width of the box and Poisson filters in texels, odd
+//   SHADOW_CASCADES	number of cascades in the shadow map, 1 to MAX_SHADOW_CASCADES
+
+// PCF_KERNEL x PCF_KERNEL taps on the texel grid
+#define SHADOW_FILTER_BOX 0
+// a single tap, the hardware's 2x2 bilinear compare
+#define SHADOW_FILTER_BILINEAR 1
+// four taps a texel apart diagonally, together they cover the 4x4 texels of four gathers
+#define SHADOW_FILTER_FOUR_TAP 2
+// POISSON_TAPS taps of a Poisson disk of diameter PCF_KERNEL, rotated per pixel
+#define SHADOW_FILTER_POISSON 3
+// one trilinear fetch of the prefiltered moments of include/evsm.glsl, the blur sets the penumbra
+#define SHADOW_FILTER_EVSM 4
+
+#ifndef SHADOW_FILTER
+#define SHADOW_FILTER SHADOW_FILTER_BOX
+#endif
+
+#ifndef PCF_KERNEL
+#define PCF_KERNEL 3
+#endif
+
+#ifndef SHADOW_CASCADES
+#define SHADOW_CASCADES 1
+#endif
+
+#define POISSON_TAPS 16
+
+uniform vec3 lightPos;
+uniform sampler2DArrayShadow shadowMap;
+uniform sampler2DArray shadowMoments;
+
+#include "evsm.glsl"
+
+#if SHADOW_FILTER == SHADOW_FILTER_POISSON
+const vec2 poissonDisk[POISSON_TAPS] = vec2[](
+	vec2(-0.94201624, -0.39906216), vec2(0.94558609, -0.76890725),
+	vec2(-0.09418410, -0.92938870), vec2(0.34495938, 0.29387760),
+	vec2(-0.91588581, 0.45771432), vec2(-0.81544232, -0.87912464),
+	vec2(-0.38277543, 0.27676845), vec2(0.97484398, 0.75648379),
+	vec2(0.44323325, -0.97511554), vec2(0.53742981, -0.47373420),
+	vec2(-0.26496911, -0.41893023), vec2(0.79197514, 0.19090188),
+	vec2(-0.24188840, 0.99706507), vec2(-0.81409955, 0.91437590),
+	vec2(0.19984126, 0.78641367), vec2(0.14383161, -0.14100790)
+);
+
+// interleaved gradient noise, the rotation changes from pixel to pixel without a noise texture
+float shadowNoise()
+{
+	return fract(52.9829189 * fract(dot(gl_FragCoord.xy, vec2(0.06711056, 0.00583715))));
+}
+#endif
+
+// fraction of the filter's taps in front of the caster, 1 is fully lit
+float shadowLit(vec2 uv, float layer, float reference)
+{
+	vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+#if SHADOW_FILTER == SHADOW_FILTER_BILINEAR
+	return texture(shadowMap, vec4(uv, layer, reference));
+#elif SHADOW_FILTER == SHADOW_FILTER_FOUR_TAP
+	float lit = texture(shadowMap, vec4(uv + vec2(-1.0, -1.0) * texelSize, layer, reference));
+	lit += texture(shadowMap, vec4(uv + vec2(1.0, -1.0) * texelSize, layer, reference));
+	lit += texture(shadowMap, vec4(uv + vec2(-1.0, 1.0) * texelSize, layer, reference));
+	lit += texture(shadowMap, vec4(uv + vec2(1.0, 1.0) * texelSize, layer, reference));
+	return lit * 0.25;
+#elif SHADOW_FILTER == SHADOW_FILTER_POISSON
+	float angle = shadowNoise() * 6.28318531;
+	mat2 rotation = mat2(cos(angle), sin(angle), -sin(angle), cos(angle));
+	vec2 radius = float(PCF_KERNEL) * 0.5 * texelSize;
+	float lit = 0.0;
+	for (int i = 0; i < POISSON_TAPS; ++i)
+		lit += texture(shadowMap, vec4(uv + rotation * poissonDisk[i] * radius, layer, reference));
+	return lit / float(POISSON_TAPS);
+#else
+	float lit = 0.0;
+	for (int x = -PCF_KERNEL / 2; x <= PCF_KERNEL / 2; ++x)
+		for (int y = -PCF_KERNEL / 2; y <= PCF_KERNEL / 2; ++y)
+			lit += texture(shadowMap, vec4(uv + vec2(x, y) * texelSize, layer, reference));
+	return lit / float(PCF_KERNEL * PCF_KERNEL);
+#endif
+}
+
+float ShadowCalculation(vec3 fragPos, vec3 normal)
+{
+#ifdef SHADOWS
+	// taken before any branch, derivatives are undefined in non-uniform control flow
+	vec3 fragPosDx = dFdx(fragPos);
+	vec3 fragPosDy = dFdy(fragPos);
+
+	// the first cascade whose slice of the view frustum holds the fragment
+	float viewDepth = -(view * vec4(fragPos, 1.0)).z;
+	int cascade = 0;
+	for (int i = 0; i < SHADOW_CASCADES - 1; ++i)
+		cascade += viewDepth > cascadeSplits[i] ? 1 : 0;
+	// nothing casts shadows beyond the shadow distance
+	if (viewDepth > cascadeSplits[SHADOW_CASCADES - 1])
+		return 0.0;
+
+    // perform perspective divide
+    vec4 fragPosLightSpace = cascadeMatrices[cascade] * vec4(fragPos, 1.0);
+    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
+
+	// transform to [0,1] range
+    projCoords = projCoords * 0.5 + 0.5;
+
+	// get depth of current fragment from light's perspective
+    float currentDepth = projCoords.z;
+
+#if SHADOW_FILTER == SHADOW_FILTER_EVSM
+	// the gradients of the cascade's coordinates follow the world position, so the mip level
+	// doesn't jump where neighbouring pixels fall into different cascades
+	vec2 uvDx = (cascadeMatrices[cascade] * vec4(fragPosDx, 0.0)).xy * 0.5;
+	vec2 uvDy = (cascadeMatrices[cascade] * vec4(fragPosDy, 0.0)).xy * 0.5;
+	vec4 moments = textureGrad(shadowMoments, vec3(projCoords.xy, cascade), uvDx, uvDy);
+	// the variance floor stands in for the bias
+	float shadow = 1.0 - MomentsLit(moments, currentDepth);
+#else
+	// calculate bias (based on depth map resolution and slope)
+    vec3 lightDir = normalize(lightPos - fragPos);
+    float bias = max(0.05 * (1.0 - dot(normal, lightDir)), 0.005);
+
+	// check whether current frag pos is in shadow, the compare passes where the stored depth
+	// is at least the reference
+    float shadow = 1.0 - shadowLit(projCoords.xy, float(cascade), currentDepth - bias);
+#endif
+
+    // keep the shadow at 0.0 when outside the far_plane region of the light's frustum.
+    if(projCoords.z > 1.0)
+        shadow = 0.0;
+
+    return shadow;
+#else
+	return 0.0;
+#endif
+}
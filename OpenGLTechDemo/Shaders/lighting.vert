@@ -8,20 +8,17 @@ out VS_OUT {
 	vec3 FragPos;
 	vec2 TexCoords;
 	vec3 Normal;
-	vec4 FragPosLightSpace;
 } vs_out;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform mat4 lightSpaceMatrix;
+
+#include "include/frame.glsl"
 
 void main() 
 {
 	vs_out.FragPos = vec3(model * vec4(aPos, 1.0f));
 	vs_out.TexCoords = aTexCoords;
 	vs_out.Normal = mat3(transpose(inverse(model))) * aNormal;
-	vs_out.FragPosLightSpace = lightSpaceMatrix * vec4(vs_out.FragPos, 1.0);
 
 	gl_Position = projection * view * vec4(vs_out.FragPos, 1.0f);
 } 
\ No newline at end of file
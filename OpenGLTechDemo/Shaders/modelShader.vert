@@ -1,6 +1,6 @@
 #version 330 core
 
-layout (location = 0) in vec3 aPos;
+layout (location = 0) in vec4 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
 
@@ -8,20 +8,33 @@ out VS_OUT {
 	vec3 FragPos;
 	vec2 TexCoords;
 	vec3 Normal;
-	vec4 FragPosLightSpace;
 } vs_out;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform mat4 lightSpaceMatrix;
+// packed meshes store positions between their bounds and octahedron encoded normals (see VertexFormat.h)
+uniform vec3 positionOffset = vec3(0.0f);
+uniform vec3 positionScale = vec3(1.0f);
+uniform bool packedNormals = false;
+
+#include "include/frame.glsl"
+
+vec3 octahedronDecode(vec2 encoded)
+{
+	vec3 n = vec3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+	// unfold the lower half
+	if (n.z < 0.0f)
+		n.xy = (1.0f - abs(n.yx)) * vec2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+	return normalize(n);
+}
 
 void main()
 {
-	vs_out.FragPos = vec3(model * vec4(aPos, 1.0f));
+	vec3 position = positionOffset + aPos.xyz * positionScale;
+	vec3 normal = packedNormals ? octahedronDecode(aNormal.xy) : aNormal;
+
+	vs_out.FragPos = vec3(model * vec4(position, 1.0f));
     vs_out.TexCoords = aTexCoords;
-	vs_out.Normal = aNormal * mat3(transpose(inverse(model)));
-	vs_out.FragPosLightSpace = lightSpaceMatrix * vec4(vs_out.FragPos, 1.0);
+	vs_out.Normal = normal * mat3(transpose(inverse(model)));
 
     gl_Position = projection * view * vec4(vs_out.FragPos, 1.0f);
 }
\ No newline at end of file
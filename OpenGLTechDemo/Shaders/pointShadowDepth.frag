@@ -0,0 +1,12 @@
+#version 330 core
+
+in vec4 FragPos;
+
+uniform vec3 lightPosition;
+uniform float farPlane;
+
+void main()
+{
+    // linear distance to the light in [0,1], compared in PointShadowCalculation
+    gl_FragDepth = length(FragPos.xyz - lightPosition) / farPlane;
+}
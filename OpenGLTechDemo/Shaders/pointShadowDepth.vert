@@ -0,0 +1,11 @@
+#version 330 core
+
+layout (location = 0) in vec3 aPos;
+
+uniform mat4 model;
+
+void main()
+{
+    // world space, pointShadowDepth.geom projects it onto the faces of the light
+    gl_Position = model * vec4(aPos, 1.0);
+}
@@ -5,14 +5,13 @@ out vec4 FragColor;
 in vec3 Normal;
 in vec3 Position;
 
-uniform vec3 cameraPos;
-uniform mat4 view;
+#include "include/frame.glsl"
 uniform samplerCube texture1;
 
 void main()
 {    
 	//reflection code
-    vec3 I = normalize(Position - cameraPos);
+    vec3 I = normalize(Position - viewPos);
     vec3 R = reflect(I, normalize(Normal));
     FragColor   = vec4(texture(texture1, R).rgb, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,41 @@
+#version 330 core
+// One pass of the separable Gaussian over the shadow moments, see ShadowMoments.
+// FROM_DEPTH: the first pass, it reads the depth of a cascade and blurs its moments.
+
+#include "include/evsm.glsl"
+
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+// the cascade's depth or the moments of the first pass
+uniform sampler2DArray source;
+uniform int layer;
+// distance between two taps in texture coordinates, along x or y
+uniform vec2 texelStep;
+// taps on either side of the center
+uniform int radius;
+
+vec4 momentsAt(vec2 uv)
+{
+	vec4 texel = texture(source, vec3(uv, layer));
+#ifdef FROM_DEPTH
+	return ShadowMomentsOf(texel.r);
+#else
+	return texel;
+#endif
+}
+
+void main()
+{
+	// the weights beyond two sigma are left out
+	float sigma = max(float(radius), 1.0) * 0.5;
+	vec4 sum = momentsAt(TexCoords);
+	float total = 1.0;
+	for (int i = 1; i <= radius; ++i) {
+		float weight = exp(-float(i * i) / (2.0 * sigma * sigma));
+		sum += weight * (momentsAt(TexCoords + texelStep * float(i)) + momentsAt(TexCoords - texelStep * float(i)));
+		total += 2.0 * weight;
+	}
+	FragColor = sum / total;
+}
@@ -3,12 +3,12 @@ layout (location = 0) in vec3 aPos;
 
 out vec3 TexCoords;
 
-uniform mat4 projection;
-uniform mat4 view;
+#include "include/frame.glsl"
 
 void main() 
 {
 	TexCoords = aPos;
-	vec4 pos = projection * view * vec4(aPos, 1.0);
+	// drop the translation so the skybox stays around the camera
+	vec4 pos = projection * mat4(mat3(view)) * vec4(aPos, 1.0);
 	gl_Position = pos.xyww;
 } 
\ No newline at end of file
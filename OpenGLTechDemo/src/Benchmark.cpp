@@ -0,0 +1,539 @@
+// Headless benchmark: renders a fixed number of frames of the demo scene into an offscreen
+// framebuffer and writes per-frame and per-pass timings as JSON.
+//
+// usage: OpenGLTechDemoBenchmark [--frames N] [--warmup N] [--kernel N] [--out file.json] [--trace trace.json]
+//                                [--replay path.replay] [--gl-counters] [--no-shader-cache]
+//                                [--pcf N] [--shadow-filter N] [--evsm-blur N] [--compare-shadow-filters] [--no-shadows] [--cascades N] [--shadow-size N] [--no-shadow-cache]
+//                                [--no-point-shadows] [--point-shadow-faces N] [--shadow-atlas N]
+//                                [--lights N] [--no-clustered] [--deferred] [--full-vertices] [--no-mesh-optimization]
+//
+// --replay renders a camera path recorded with OpenGLTechDemo --record instead of the start view,
+// one frame per recorded frame. The recorded settings are ignored, the command line sets them. --gl-counters adds the GL calls of the last frame to the JSON;
+// it wraps the GL entry points, so leave it off when comparing timings.
+// --trace also writes the CPU profiling zones of the run (startup included) as a Chrome trace.
+// --no-shader-cache compiles every shader from source, to time a cold start.
+// --pcf, --shadow-filter (0 box, 1 bilinear, 2 4-tap, 3 Poisson disk, 4 EVSM) and --no-shadows
+// select the permutation of the lit shaders, --no-shadows also skips every shadow pass.
+// --evsm-blur sets the radius of the EVSM prefilter.
+// --compare-shadow-filters renders the last frame again with every filter, and adds their lit
+// and prefilter pass times and their error against a 7x7 box filter to the JSON.
+// --cascades (1 to 4) and
+// --shadow-size set the number and resolution of the directional light's shadow cascades, the
+// size is rounded up to a power of two from 512 to 4096.
+// --no-shadow-cache draws the static shadow casters every frame instead of copying their cached depth.
+// --no-point-shadows turns the point lights' shadows off, --point-shadow-faces sets how many of
+// their faces may be drawn per frame and --shadow-atlas the size of the atlas they share, rounded
+// up to a power of two.
+// --lights adds N point lights over the floor, --no-clustered shades through the uniform block
+// instead of the clustered light lists (which then only sees the scene's own lights).
+// --deferred renders the floor and the models through the G-buffer and the deferred lighting pass.
+// --full-vertices loads the models with the 56 byte float vertices instead of the packed 20 byte ones.
+// --no-mesh-optimization keeps the models' triangles and vertices in file order, the JSON reports
+// their simulated vertex cache cost (ACMR, ATVR) in file order and as drawn either way.
+//
+// On Linux the context is created through EGL on Mesa's surfaceless platform, so no display
+// or GPU is needed (llvmpipe works). Everywhere else a hidden GLFW window is used.
+// Linux build: CMakeLists.txt, run the binary from the OpenGLTechDemo directory.
+#include <glad/glad.h>
+
+#if defined(__linux__)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#else
+#include <GLFW/glfw3.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Scene.h"
+#include "Profiler.h"
+#include "Replay.h"
+#include "GLCounters.h"
+#include "ShaderCache.h"
+#include "ShaderBatch.h"
+
+typedef std::chrono::high_resolution_clock Clock;
+
+// load linked programs from the on-disk cache
+bool useShaderCache = true;
+
+struct PassTiming {
+	std::string name;
+	Clock::time_point start;
+};
+
+// timings of the frame currently being rendered, keyed by pass path ("lit/drawFloor")
+std::vector<PassTiming> passStack;
+std::map<std::string, double> framePasses;
+// pass paths in the order they first ran, so the output follows the render loop
+std::vector<std::string> passOrder;
+
+std::string passPath(const std::string &name)
+{
+	std::string path;
+	for (size_t i = 0; i < passStack.size(); i++)
+		path += passStack[i].name + '/';
+	return path + name;
+}
+
+// passCallback: wait for the GPU at pass boundaries so each pass is charged for its own work
+void timePass(const char* name, bool begin)
+{
+	glFinish();
+	Clock::time_point now = Clock::now();
+
+	if (begin) {
+		std::string path = passPath(name);
+		if (std::find(passOrder.begin(), passOrder.end(), path) == passOrder.end())
+			passOrder.push_back(path);
+
+		PassTiming timing;
+		timing.name = name;
+		timing.start = now;
+		passStack.push_back(timing);
+		return;
+	}
+
+	PassTiming timing = passStack.back();
+	passStack.pop_back();
+	framePasses[passPath(timing.name)] += std::chrono::duration<double, std::milli>(now - timing.start).count();
+}
+
+#if defined(__linux__)
+EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+EGLContext eglContext = EGL_NO_CONTEXT;
+
+bool createContext()
+{
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (getPlatformDisplay)
+		eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+	if (eglDisplay == EGL_NO_DISPLAY)
+		eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+	EGLint major, minor;
+	if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor)) {
+		std::cout << "Error::Benchmark: failed to initialize EGL." << std::endl;
+		return false;
+	}
+
+	const EGLint configAttribs[] = {
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_NONE
+	};
+	EGLConfig config;
+	EGLint numConfigs = 0;
+	eglChooseConfig(eglDisplay, configAttribs, &config, 1, &numConfigs);
+
+	const EGLint contextAttribs[] = {
+		EGL_CONTEXT_MAJOR_VERSION, 3,
+		EGL_CONTEXT_MINOR_VERSION, 3,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		EGL_NONE
+	};
+	eglBindAPI(EGL_OPENGL_API);
+	eglContext = eglCreateContext(eglDisplay, numConfigs > 0 ? config : EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttribs);
+	if (eglContext == EGL_NO_CONTEXT || !eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext)) {
+		std::cout << "Error::Benchmark: failed to create a surfaceless OpenGL 3.3 context." << std::endl;
+		return false;
+	}
+
+	if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress))
+		return false;
+	if (useShaderCache)
+		ShaderCache::Init((GLADloadproc)eglGetProcAddress);
+	ShaderBatch::Init((GLADloadproc)eglGetProcAddress);
+	return true;
+}
+
+void destroyContext()
+{
+	eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	eglDestroyContext(eglDisplay, eglContext);
+	eglTerminate(eglDisplay);
+}
+#else
+GLFWwindow* hiddenWindow = nullptr;
+
+bool createContext()
+{
+	glfwInit();
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+	hiddenWindow = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "OpenGLDemoBenchmark", nullptr, nullptr);
+	if (hiddenWindow == nullptr) {
+		std::cout << "Error::Benchmark: failed to create window." << std::endl;
+		return false;
+	}
+	glfwMakeContextCurrent(hiddenWindow);
+	glfwSwapInterval(0);
+
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+		return false;
+	if (useShaderCache)
+		ShaderCache::Init((GLADloadproc)glfwGetProcAddress);
+	ShaderBatch::Init((GLADloadproc)glfwGetProcAddress);
+	return true;
+}
+
+void destroyContext()
+{
+	glfwTerminate();
+}
+#endif
+
+// offscreen replacement for the window's default framebuffer
+void offscreenFramebuffer()
+{
+	unsigned int colorbuffer, rbo;
+	glGenFramebuffers(1, &sceneFBO);
+	glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
+	glGenRenderbuffers(1, &colorbuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, colorbuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, SCR_WIDTH, SCR_HEIGHT);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorbuffer);
+	glGenRenderbuffers(1, &rbo);
+	glBindRenderbuffer(GL_RENDERBUFFER, rbo);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, SCR_WIDTH, SCR_HEIGHT);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, rbo);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "Error::Framebuffer: Framebuffer is not complete." << std::endl;
+}
+
+const char* shadowFilterNames[SHADOW_FILTER_COUNT] = { "box", "bilinear", "four_tap", "poisson", "evsm" };
+
+struct FilterRun {
+	std::vector<double> frameTimes;
+	std::vector<double> litTimes;
+	// moments pass of EVSM, 0 for the others
+	std::vector<double> prefilterTimes;
+	std::vector<unsigned char> image;
+};
+
+// renders the current frame repeatedly with one shadow filter and keeps the final image
+void renderFilter(SceneShaders &shaders, int filter, int kernel, int frames, FilterRun &run)
+{
+	shadowFilter = filter;
+	pcfKernel = kernel;
+	// the first frame compiles the permutation
+	for (int i = -1; i < frames; i++) {
+		framePasses.clear();
+		glFinish();
+		Clock::time_point start = Clock::now();
+		renderScene(shaders);
+		glFinish();
+		if (i >= 0) {
+			run.frameTimes.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+			run.litTimes.push_back(framePasses["lit"]);
+			run.prefilterTimes.push_back(framePasses["shadowMoments"]);
+		}
+	}
+
+	run.image.resize(SCR_WIDTH * SCR_HEIGHT * 4);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, sceneFBO);
+	glReadPixels(0, 0, SCR_WIDTH, SCR_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, run.image.data());
+}
+
+// root mean square and largest difference of two images, in 0-255 steps per channel
+void imageError(const std::vector<unsigned char> &image, const std::vector<unsigned char> &reference, double &rmse, int &maxError)
+{
+	double sum = 0.0;
+	maxError = 0;
+	for (size_t i = 0; i < image.size(); i++) {
+		int difference = std::abs((int)image[i] - (int)reference[i]);
+		sum += (double)difference * difference;
+		maxError = std::max(maxError, difference);
+	}
+	rmse = image.empty() ? 0.0 : std::sqrt(sum / image.size());
+}
+
+// size of the vertex buffers of the house and ori in the layout they were loaded with
+size_t modelVertexBytes()
+{
+	const Model* models[] = { &house, &ori };
+	size_t bytes = 0;
+	for (const Model* model : models)
+		for (size_t i = 0; i < model->meshes.size(); i++)
+			bytes += model->meshes[i].vertices.size() * VertexFormat::Get(model->meshes[i].Layout).stride;
+	return bytes;
+}
+
+void writeCacheStats(std::ostream &out, const char* name, const Model &model)
+{
+	out << "\"" << name << "\": {\"triangles\": " << model.CacheAfter.triangles << ", \"vertices\": " << model.CacheAfter.vertices
+		<< ", \"acmr_before\": " << model.CacheBefore.ACMR() << ", \"acmr_after\": " << model.CacheAfter.ACMR()
+		<< ", \"atvr_before\": " << model.CacheBefore.ATVR() << ", \"atvr_after\": " << model.CacheAfter.ATVR() << "}";
+}
+
+// value at percentile p (0-100) of the samples
+double percentile(std::vector<double> samples, double p)
+{
+	if (samples.empty())
+		return 0.0;
+	std::sort(samples.begin(), samples.end());
+	size_t index = (size_t)(p / 100.0 * (samples.size() - 1) + 0.5);
+	return samples[std::min(index, samples.size() - 1)];
+}
+
+void writeStats(std::ostream &out, const std::vector<double> &samples)
+{
+	double sum = 0.0;
+	for (size_t i = 0; i < samples.size(); i++)
+		sum += samples[i];
+	out << "{\"mean\": " << (samples.empty() ? 0.0 : sum / samples.size())
+		<< ", \"min\": " << percentile(samples, 0.0)
+		<< ", \"p50\": " << percentile(samples, 50.0)
+		<< ", \"p95\": " << percentile(samples, 95.0)
+		<< ", \"p99\": " << percentile(samples, 99.0)
+		<< ", \"max\": " << percentile(samples, 100.0) << "}";
+}
+
+int main(int argc, char** argv)
+{
+	int frames = 300;
+	int warmup = 10;
+	std::string outPath = "benchmark.json";
+	std::string tracePath;
+	std::string replayPath;
+	Replay replay;
+	bool countGLCalls = false;
+	bool compareShadowFilters = false;
+
+	for (int i = 1; i < argc; i++) {
+		const char* option = argv[i];
+		if (std::strcmp(option, "--gl-counters") == 0) {
+			countGLCalls = true;
+			continue;
+		}
+		if (std::strcmp(option, "--no-shader-cache") == 0) {
+			useShaderCache = false;
+			continue;
+		}
+		if (std::strcmp(option, "--no-shadows") == 0) {
+			shadows = false;
+			continue;
+		}
+		if (std::strcmp(option, "--compare-shadow-filters") == 0) {
+			compareShadowFilters = true;
+			continue;
+		}
+		if (std::strcmp(option, "--no-shadow-cache") == 0) {
+			shadowCache = false;
+			continue;
+		}
+		if (std::strcmp(option, "--no-point-shadows") == 0) {
+			pointLightShadows = false;
+			continue;
+		}
+		if (std::strcmp(option, "--no-clustered") == 0) {
+			clusteredShading = false;
+			continue;
+		}
+		if (std::strcmp(option, "--deferred") == 0) {
+			deferredShading = true;
+			continue;
+		}
+		if (std::strcmp(option, "--full-vertices") == 0) {
+			modelVertexLayout = FullVertexLayout;
+			continue;
+		}
+		if (std::strcmp(option, "--no-mesh-optimization") == 0) {
+			optimizeMeshes = false;
+			continue;
+		}
+		if (i + 1 >= argc) {
+			std::cout << "Missing value for " << option << std::endl;
+			break;
+		}
+
+		const char* value = argv[++i];
+		if (std::strcmp(option, "--frames") == 0)
+			frames = std::atoi(value);
+		else if (std::strcmp(option, "--warmup") == 0)
+			warmup = std::atoi(value);
+		else if (std::strcmp(option, "--kernel") == 0)
+			activeKernel = std::atoi(value);
+		else if (std::strcmp(option, "--pcf") == 0)
+			pcfKernel = std::atoi(value);
+		else if (std::strcmp(option, "--shadow-filter") == 0)
+			shadowFilter = std::atoi(value);
+		else if (std::strcmp(option, "--evsm-blur") == 0)
+			shadowMoments.BlurRadius = std::atoi(value);
+		else if (std::strcmp(option, "--cascades") == 0)
+			shadowCascadeCount = std::atoi(value);
+		else if (std::strcmp(option, "--shadow-size") == 0)
+			shadowMapSize = std::atoi(value);
+		else if (std::strcmp(option, "--point-shadow-faces") == 0)
+			pointShadowFaceBudget = std::atoi(value);
+		else if (std::strcmp(option, "--shadow-atlas") == 0)
+			shadowAtlasSize = std::atoi(value);
+		else if (std::strcmp(option, "--lights") == 0)
+			extraLights = std::atoi(value);
+		else if (std::strcmp(option, "--out") == 0)
+			outPath = value;
+		else if (std::strcmp(option, "--trace") == 0)
+			tracePath = value;
+		else if (std::strcmp(option, "--replay") == 0) {
+			if (!replay.StartPlayback(value))
+				return -1;
+			frames = replay.FrameCount();
+			replayPath = value;
+		} else
+			std::cout << "Unknown argument: " << option << std::endl;
+	}
+
+	Profiler::SetThreadName("main");
+
+	if (!createContext())
+		return -1;
+
+	if (countGLCalls)
+		GLCounters::Install();
+
+	offscreenFramebuffer();
+
+	SceneShaders shaders;
+	Clock::time_point loadStart = Clock::now();
+	loadScene(shaders);
+	double loadTime = std::chrono::duration<double, std::milli>(Clock::now() - loadStart).count();
+
+	std::vector<double> frameTimes;
+	std::vector<std::map<std::string, double> > passTimes;
+
+	passCallback = timePass;
+	for (int i = -warmup; i < frames; i++) {
+		framePasses.clear();
+		// fixed simulation step so every run animates the same frames
+		if (replay.IsPlaying()) {
+			// warmup repeats the first recorded frame
+			replay.Apply(camera, false);
+			sceneTime = replay.SimulatedTime();
+		} else
+			sceneTime = (i + warmup) * Replay::TIME_STEP;
+
+		glFinish();
+		GLCounters::BeginFrame();
+		Clock::time_point start = Clock::now();
+		{
+			PROFILE_ZONE("frame");
+			renderScene(shaders);
+			glFinish();
+		}
+		double frameTime = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		GLCounters::EndFrame();
+
+		if (i >= 0) {
+			frameTimes.push_back(frameTime);
+			passTimes.push_back(framePasses);
+			replay.NextFrame();
+		}
+	}
+
+	// same camera, time and shadow maps for every filter, only the lit shaders change
+	std::vector<FilterRun> filterRuns;
+	FilterRun referenceRun;
+	if (compareShadowFilters) {
+		int mainFilter = shadowFilter, mainKernel = pcfKernel;
+		int filterFrames = std::max(std::min(frames, 60), 1);
+		renderFilter(shaders, ShadowFilterBox, 7, 1, referenceRun);
+		filterRuns.resize(SHADOW_FILTER_COUNT);
+		for (int f = 0; f < SHADOW_FILTER_COUNT; f++)
+			renderFilter(shaders, f, mainKernel, filterFrames, filterRuns[f]);
+		shadowFilter = mainFilter;
+		pcfKernel = mainKernel;
+	}
+	passCallback = nullptr;
+
+	std::ofstream out(outPath.c_str());
+	out << "{\n";
+	out << "  \"renderer\": \"" << (const char*)glGetString(GL_RENDERER) << "\",\n";
+	out << "  \"version\": \"" << (const char*)glGetString(GL_VERSION) << "\",\n";
+	out << "  \"width\": " << SCR_WIDTH << ", \"height\": " << SCR_HEIGHT << ",\n";
+	out << "  \"frames\": " << frames << ", \"warmup\": " << warmup << ", \"kernel\": " << activeKernel << ",\n";
+	out << "  \"replay\": \"" << replayPath << "\",\n";
+	out << "  \"shadows\": " << (shadows ? "true" : "false") << ", \"shadow_filter\": \"" << shadowFilterNames[litFeatures().shadowFilter] << "\""
+		<< ", \"evsm_blur\": " << shadowMoments.BlurRadius << ", \"pcf_kernel\": " << litFeatures().pcfKernel
+		<< ", \"shadow_cascades\": " << litFeatures().shadowCascades << ", \"shadow_map_size\": " << shadowCascades.Resolution()
+		<< ", \"shadow_cache\": " << (shadowCache ? "true" : "false") << ",\n";
+	out << "  \"point_shadows\": " << (litFeatures().pointShadows ? "true" : "false") << ", \"point_shadow_faces\": " << pointShadowFaceBudget
+		<< ", \"shadow_atlas_size\": " << shadowAtlas.Size() << ", \"shadow_atlas_used_texels\": " << shadowAtlas.UsedTexels() << ",\n";
+	out << "  \"deferred\": " << (deferredShading ? "true" : "false") << ",\n";
+	out << "  \"vertex_layout\": \"" << (modelVertexLayout == PackedVertexLayout ? "packed" : "full") << "\", \"vertex_bytes\": "
+		<< VertexFormat::Get(modelVertexLayout).stride << ", \"model_vertex_buffer_bytes\": " << modelVertexBytes() << ",\n";
+	out << "  \"mesh_optimization\": " << (optimizeMeshes ? "true" : "false") << ", \"vertex_cache_size\": " << VERTEX_CACHE_SIZE << ", \"vertex_cache\": {";
+	writeCacheStats(out, "house", house);
+	out << ", ";
+	writeCacheStats(out, "ori", ori);
+	out << "},\n";
+	out << "  \"clustered\": " << (clusteredShading ? "true" : "false") << ", \"lights\": " << lightManager.Count()
+		<< ", \"cluster_light_ids\": " << clusteredLights.IndexCount() << ", \"max_cluster_lights\": " << clusteredLights.MaxClusterLights() << ",\n";
+	out << "  \"load_scene_ms\": " << loadTime << ", \"shader_cache\": {\"enabled\": " << (ShaderCache::Enabled() ? "true" : "false")
+		<< ", \"hits\": " << ShaderCache::Hits() << ", \"misses\": " << ShaderCache::Misses() << "}"
+		<< ", \"parallel_shader_compile\": " << (ShaderBatch::ParallelCompile() ? "true" : "false") << ",\n";
+
+	out << "  \"summary\": {\n    \"frame_ms\": ";
+	writeStats(out, frameTimes);
+	out << ",\n    \"passes_ms\": {";
+	for (size_t p = 0; p < passOrder.size(); p++) {
+		std::vector<double> samples;
+		for (size_t i = 0; i < passTimes.size(); i++)
+			samples.push_back(passTimes[i][passOrder[p]]);
+		out << (p ? "," : "") << "\n      \"" << passOrder[p] << "\": ";
+		writeStats(out, samples);
+	}
+	out << "\n    }";
+	if (GLCounters::Installed()) {
+		// every measured frame issues the same calls, the last one stands for all of them
+		out << ",\n    \"gl_calls_per_frame\": ";
+		GLCounters::WriteJson(out, GLCounters::LastFrame());
+	}
+	out << "\n  },\n";
+
+	if (compareShadowFilters) {
+		out << "  \"shadow_filters\": {";
+		for (int f = 0; f < SHADOW_FILTER_COUNT; f++) {
+			double rmse;
+			int maxError;
+			imageError(filterRuns[f].image, referenceRun.image, rmse, maxError);
+			out << (f ? "," : "") << "\n    \"" << shadowFilterNames[f] << "\": {\"frame_ms\": ";
+			writeStats(out, filterRuns[f].frameTimes);
+			out << ", \"lit_ms\": ";
+			writeStats(out, filterRuns[f].litTimes);
+			out << ", \"prefilter_ms\": ";
+			writeStats(out, filterRuns[f].prefilterTimes);
+			out << ", \"rmse\": " << rmse << ", \"max_error\": " << maxError << "}";
+		}
+		out << "\n  },\n";
+	}
+
+	out << "  \"per_frame\": [";
+	for (size_t i = 0; i < frameTimes.size(); i++) {
+		out << (i ? "," : "") << "\n    {\"frame\": " << i << ", \"frame_ms\": " << frameTimes[i] << ", \"passes_ms\": {";
+		for (size_t p = 0; p < passOrder.size(); p++)
+			out << (p ? ", " : "") << "\"" << passOrder[p] << "\": " << passTimes[i][passOrder[p]];
+		out << "}}";
+	}
+	out << "\n  ]\n}\n";
+	out.close();
+
+	if (!tracePath.empty())
+		Profiler::ExportChromeTrace(tracePath);
+
+	std::cout << "Benchmark: " << frames << " frames, median " << percentile(frameTimes, 50.0) << " ms/frame, written to " << outPath << std::endl;
+
+	destroyContext();
+	return 0;
+}
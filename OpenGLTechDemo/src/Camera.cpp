@@ -65,6 +65,15 @@ void Camera::ProcessMouseScroll(float yoffset)
 		Zoom = 45.0f;
 }
 
+void Camera::SetState(glm::vec3 position, float yaw, float pitch, float zoom)
+{
+	Position = position;
+	Yaw = yaw;
+	Pitch = pitch;
+	Zoom = zoom;
+	updateCameraVectors();
+}
+
 void Camera::updateCameraVectors()
 {
 	// calculate the new Front vector
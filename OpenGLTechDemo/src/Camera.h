@@ -34,6 +34,8 @@ public:
 	void ProcessKeyboard(Camera_Movement direction, float deltaTime);
 	void ProcessMouseMovement(float xoffset, float yoffset, GLboolean constrainPitch = true);
 	void ProcessMouseScroll(float yoffset);
+	// places the camera directly, used to replay recorded frames
+	void SetState(glm::vec3 position, float yaw, float pitch, float zoom);
 
 private:
 	void updateCameraVectors();
@@ -0,0 +1,294 @@
+#include "ClusteredLights.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CLUSTER_SSE2
+#endif
+
+#include "Profiler.h"
+
+namespace {
+	// below this many lights the threads cost more than they save
+	const unsigned int PARALLEL_MIN_LIGHTS = 256;
+	const unsigned int MAX_WORKERS = 7;
+
+	int tileOf(float ndc, unsigned int tiles)
+	{
+		int tile = (int)std::floor((ndc * 0.5f + 0.5f) * tiles);
+		return std::min(std::max(tile, 0), (int)tiles - 1);
+	}
+
+	int sliceOf(float depth, const glm::vec4 &params)
+	{
+		int slice = (int)std::floor(std::log(depth) * params.z + params.w);
+		return std::min(std::max(slice, 0), (int)ClusteredLights::GRID_Z - 1);
+	}
+
+	// sphere against the bounds of the four clusters from index on, bit n is set when the
+	// sphere touches cluster index + n
+	unsigned int touches4(const float* minX, const float* minY, const float* minZ, const float* maxX, const float* maxY, const float* maxZ,
+		unsigned int index, const glm::vec4 &sphere)
+	{
+#ifdef CLUSTER_SSE2
+		const __m128 zero = _mm_setzero_ps();
+		__m128 c = _mm_set1_ps(sphere.x);
+		__m128 d = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(minX + index), c), zero), _mm_max_ps(_mm_sub_ps(c, _mm_loadu_ps(maxX + index)), zero));
+		__m128 distance2 = _mm_mul_ps(d, d);
+		c = _mm_set1_ps(sphere.y);
+		d = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(minY + index), c), zero), _mm_max_ps(_mm_sub_ps(c, _mm_loadu_ps(maxY + index)), zero));
+		distance2 = _mm_add_ps(distance2, _mm_mul_ps(d, d));
+		c = _mm_set1_ps(sphere.z);
+		d = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(minZ + index), c), zero), _mm_max_ps(_mm_sub_ps(c, _mm_loadu_ps(maxZ + index)), zero));
+		distance2 = _mm_add_ps(distance2, _mm_mul_ps(d, d));
+		return (unsigned int)_mm_movemask_ps(_mm_cmple_ps(distance2, _mm_set1_ps(sphere.w * sphere.w)));
+#else
+		unsigned int mask = 0;
+		for (unsigned int i = 0; i < 4; i++) {
+			unsigned int n = index + i;
+			float dx = std::max(minX[n] - sphere.x, 0.0f) + std::max(sphere.x - maxX[n], 0.0f);
+			float dy = std::max(minY[n] - sphere.y, 0.0f) + std::max(sphere.y - maxY[n], 0.0f);
+			float dz = std::max(minZ[n] - sphere.z, 0.0f) + std::max(sphere.z - maxZ[n], 0.0f);
+			if (dx * dx + dy * dy + dz * dz <= sphere.w * sphere.w)
+				mask |= 1u << i;
+		}
+		return mask;
+#endif
+	}
+}
+
+static_assert(ClusteredLights::GRID_X % 4 == 0, "rows of clusters are tested four at a time");
+
+ClusteredLights::ClusteredLights()
+	: boundsProjection(0.0f), boundsNear(0.0f), boundsFar(0.0f), clusterLights(CLUSTER_COUNT),
+	workGeneration(0), workPending(0), workParts(1), stopping(false), maxClusterLights(0),
+	gridBuffer(0), gridTexture(0), indexBuffer(0), indexTexture(0)
+{
+}
+
+ClusteredLights::~ClusteredLights()
+{
+	{
+		std::lock_guard<std::mutex> lock(workMutex);
+		stopping = true;
+	}
+	workReady.notify_all();
+	for (std::thread &worker : workers)
+		worker.join();
+}
+
+void ClusteredLights::Update(const LightManager &lights, const glm::mat4 &view, const glm::mat4 &projection, float nearPlane, float farPlane)
+{
+	PROFILE_FUNCTION();
+
+	if (projection != boundsProjection || nearPlane != boundsNear || farPlane != boundsFar)
+		buildBounds(projection, nearPlane, farPlane);
+
+	// view-space sphere of every light and the clusters its screen and depth bounds cover
+	unsigned int count = lights.Count();
+	const glm::vec3* positions = lights.Positions();
+	const float* ranges = lights.Ranges();
+	glm::vec4 params = ShaderParams(GRID_X, GRID_Y, nearPlane, farPlane);
+	bounds.resize(count);
+	for (unsigned int i = 0; i < count; i++) {
+		LightBounds &light = bounds[i];
+		glm::vec3 center = glm::vec3(view * glm::vec4(positions[i], 1.0f));
+		float radius = ranges[i];
+		float depth = -center.z;
+		light.sphere = glm::vec4(center, radius);
+		light.x0 = light.y0 = light.z0 = 0;
+		light.x1 = GRID_X - 1;
+		light.y1 = GRID_Y - 1;
+		light.z1 = -1;
+		if (depth + radius < nearPlane || depth - radius > farPlane)
+			continue;
+
+		// the projection of the box around the sphere, unless it reaches behind the near plane
+		float front = depth - radius, back = depth + radius;
+		if (front > nearPlane) {
+			float left = std::min((center.x - radius) / front, (center.x - radius) / back) * projection[0][0];
+			float right = std::max((center.x + radius) / front, (center.x + radius) / back) * projection[0][0];
+			float bottom = std::min((center.y - radius) / front, (center.y - radius) / back) * projection[1][1];
+			float top = std::max((center.y + radius) / front, (center.y + radius) / back) * projection[1][1];
+			if (left > 1.0f || right < -1.0f || bottom > 1.0f || top < -1.0f)
+				continue;
+			light.x0 = tileOf(left, GRID_X);
+			light.x1 = tileOf(right, GRID_X);
+			light.y0 = tileOf(bottom, GRID_Y);
+			light.y1 = tileOf(top, GRID_Y);
+		}
+		light.z0 = sliceOf(std::max(front, nearPlane), params);
+		light.z1 = sliceOf(std::min(back, farPlane), params);
+	}
+
+	// interleaved slices balance the threads when the lights bunch up at some depth
+	if (count >= PARALLEL_MIN_LIGHTS && workers.empty())
+		startWorkers();
+	if (count >= PARALLEL_MIN_LIGHTS && !workers.empty()) {
+		{
+			std::lock_guard<std::mutex> lock(workMutex);
+			workPending = (unsigned int)workers.size();
+			workGeneration++;
+		}
+		workReady.notify_all();
+		assignSlices(0, workParts);
+
+		std::unique_lock<std::mutex> lock(workMutex);
+		workDone.wait(lock, [this]() { return workPending == 0; });
+	}
+	else
+		assignSlices(0, 1);
+
+	// concatenate the lists
+	grid.resize(CLUSTER_COUNT * 2);
+	indices.clear();
+	maxClusterLights = 0;
+	for (unsigned int c = 0; c < CLUSTER_COUNT; c++) {
+		grid[c * 2] = (unsigned int)indices.size();
+		grid[c * 2 + 1] = (unsigned int)clusterLights[c].size();
+		indices.insert(indices.end(), clusterLights[c].begin(), clusterLights[c].end());
+		maxClusterLights = std::max(maxClusterLights, (unsigned int)clusterLights[c].size());
+	}
+
+	upload();
+}
+
+void ClusteredLights::Bind(GLenum gridUnit, GLenum indexUnit) const
+{
+	glActiveTexture(gridUnit);
+	glBindTexture(GL_TEXTURE_BUFFER, gridTexture);
+	glActiveTexture(indexUnit);
+	glBindTexture(GL_TEXTURE_BUFFER, indexTexture);
+}
+
+glm::vec4 ClusteredLights::ShaderParams(unsigned int width, unsigned int height, float nearPlane, float farPlane)
+{
+	float scale = GRID_Z / std::log(farPlane / nearPlane);
+	return glm::vec4((float)width / GRID_X, (float)height / GRID_Y, scale, -std::log(nearPlane) * scale);
+}
+
+void ClusteredLights::buildBounds(const glm::mat4 &projection, float nearPlane, float farPlane)
+{
+	PROFILE_FUNCTION();
+
+	boundsProjection = projection;
+	boundsNear = nearPlane;
+	boundsFar = farPlane;
+	minX.resize(CLUSTER_COUNT);
+	minY.resize(CLUSTER_COUNT);
+	minZ.resize(CLUSTER_COUNT);
+	maxX.resize(CLUSTER_COUNT);
+	maxY.resize(CLUSTER_COUNT);
+	maxZ.resize(CLUSTER_COUNT);
+
+	// a point at NDC (x, y) and view depth d lies at (x * d / P[0][0], y * d / P[1][1], -d)
+	for (unsigned int z = 0; z < GRID_Z; z++) {
+		float front = nearPlane * std::pow(farPlane / nearPlane, (float)z / GRID_Z);
+		float back = nearPlane * std::pow(farPlane / nearPlane, (float)(z + 1) / GRID_Z);
+		for (unsigned int y = 0; y < GRID_Y; y++) {
+			float bottom = -1.0f + 2.0f * y / GRID_Y;
+			float top = -1.0f + 2.0f * (y + 1) / GRID_Y;
+			for (unsigned int x = 0; x < GRID_X; x++) {
+				float left = -1.0f + 2.0f * x / GRID_X;
+				float right = -1.0f + 2.0f * (x + 1) / GRID_X;
+				unsigned int c = x + GRID_X * (y + GRID_Y * z);
+				minX[c] = std::min(left * front, left * back) / projection[0][0];
+				maxX[c] = std::max(right * front, right * back) / projection[0][0];
+				minY[c] = std::min(bottom * front, bottom * back) / projection[1][1];
+				maxY[c] = std::max(top * front, top * back) / projection[1][1];
+				minZ[c] = -back;
+				maxZ[c] = -front;
+			}
+		}
+	}
+}
+
+void ClusteredLights::startWorkers()
+{
+	unsigned int threads = std::thread::hardware_concurrency();
+	unsigned int count = std::min(threads > 1 ? threads - 1 : 0u, MAX_WORKERS);
+	workParts = count + 1;
+	for (unsigned int i = 0; i < count; i++)
+		workers.push_back(std::thread(&ClusteredLights::workerLoop, this, i + 1));
+}
+
+void ClusteredLights::workerLoop(unsigned int part)
+{
+	Profiler::SetThreadName("cluster worker");
+
+	unsigned int generation = 0;
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(workMutex);
+			workReady.wait(lock, [&]() { return stopping || workGeneration != generation; });
+			if (stopping)
+				return;
+			generation = workGeneration;
+		}
+
+		assignSlices(part, workParts);
+
+		std::lock_guard<std::mutex> lock(workMutex);
+		if (--workPending == 0)
+			workDone.notify_one();
+	}
+}
+
+void ClusteredLights::assignSlices(unsigned int part, unsigned int parts)
+{
+	PROFILE_FUNCTION();
+
+	for (unsigned int z = part; z < GRID_Z; z += parts)
+		for (unsigned int c = z * GRID_X * GRID_Y; c < (z + 1) * GRID_X * GRID_Y; c++)
+			clusterLights[c].clear();
+
+	for (unsigned int i = 0; i < bounds.size(); i++) {
+		const LightBounds &light = bounds[i];
+		// first slice of this part inside the light's range
+		int first = light.z0 + (int)((part + parts - light.z0 % parts) % parts);
+		for (int z = first; z <= light.z1; z += parts) {
+			for (int y = light.y0; y <= light.y1; y++) {
+				unsigned int row = GRID_X * (y + GRID_Y * z);
+				for (int x = light.x0 & ~3; x <= light.x1; x += 4) {
+					unsigned int mask = touches4(minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data(), row + x, light.sphere);
+					for (int n = 0; n < 4; n++)
+						if ((mask & (1u << n)) && x + n >= light.x0 && x + n <= light.x1)
+							clusterLights[row + x + n].push_back(i);
+				}
+			}
+		}
+	}
+}
+
+void ClusteredLights::upload()
+{
+	// initialize if necessary
+	if (gridTexture == 0) {
+		glGenBuffers(1, &gridBuffer);
+		glGenTextures(1, &gridTexture);
+		glGenBuffers(1, &indexBuffer);
+		glGenTextures(1, &indexTexture);
+
+		glBindBuffer(GL_TEXTURE_BUFFER, gridBuffer);
+		glBufferData(GL_TEXTURE_BUFFER, grid.size() * sizeof(unsigned int), nullptr, GL_STREAM_DRAW);
+		glBindBuffer(GL_TEXTURE_BUFFER, indexBuffer);
+		glBufferData(GL_TEXTURE_BUFFER, sizeof(unsigned int), nullptr, GL_STREAM_DRAW);
+		glBindTexture(GL_TEXTURE_BUFFER, gridTexture);
+		glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32UI, gridBuffer);
+		glBindTexture(GL_TEXTURE_BUFFER, indexTexture);
+		glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, indexBuffer);
+		glBindTexture(GL_TEXTURE_BUFFER, 0);
+	}
+
+	// new storage every frame, so the driver doesn't wait for the last frame's draws
+	glBindBuffer(GL_TEXTURE_BUFFER, gridBuffer);
+	glBufferData(GL_TEXTURE_BUFFER, grid.size() * sizeof(unsigned int), grid.data(), GL_STREAM_DRAW);
+	glBindBuffer(GL_TEXTURE_BUFFER, indexBuffer);
+	if (indices.empty())
+		glBufferData(GL_TEXTURE_BUFFER, sizeof(unsigned int), nullptr, GL_STREAM_DRAW);
+	else
+		glBufferData(GL_TEXTURE_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STREAM_DRAW);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
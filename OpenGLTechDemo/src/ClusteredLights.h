@@ -0,0 +1,89 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "LightManager.h"
+
+// Clustered forward shading. The camera frustum is split into a froxel grid of GRID_X x GRID_Y
+// screen tiles and GRID_Z slices, exponentially spaced in depth. Update() bins every light of
+// the LightManager into the clusters its range touches, on worker threads once there are enough
+// lights, and uploads the result as two texture buffers (GL 3.3 has no SSBOs):
+//  - the grid, one RG32UI texel per cluster with the offset and count of its light list
+//  - the light lists, R32UI light ids indexing the LightManager's light texture
+// Fragments then shade only the lights of their cluster (CLUSTERED in include/lights.glsl).
+class ClusteredLights {
+public:
+	// must match CLUSTER_GRID_* in include/lights.glsl
+	static const unsigned int GRID_X = 16;
+	static const unsigned int GRID_Y = 9;
+	static const unsigned int GRID_Z = 24;
+	static const unsigned int CLUSTER_COUNT = GRID_X * GRID_Y * GRID_Z;
+
+	ClusteredLights();
+	~ClusteredLights();
+	ClusteredLights(const ClusteredLights&) = delete;
+	ClusteredLights& operator=(const ClusteredLights&) = delete;
+
+	// rebuilds the light lists for the camera, projection must be a symmetric perspective
+	void Update(const LightManager &lights, const glm::mat4 &view, const glm::mat4 &projection, float nearPlane, float farPlane);
+	// binds the grid and the light lists to the texture units
+	void Bind(GLenum gridUnit, GLenum indexUnit) const;
+
+	// tile size in pixels, then the scale and bias turning log(view depth) into a slice
+	static glm::vec4 ShaderParams(unsigned int width, unsigned int height, float nearPlane, float farPlane);
+
+	// light ids in all lists and the longest list of the last Update()
+	unsigned int IndexCount() const { return (unsigned int)indices.size(); }
+	unsigned int MaxClusterLights() const { return maxClusterLights; }
+
+private:
+	// view-space bounds of every cluster, one array per axis so four clusters of a row are
+	// tested against a light at once
+	std::vector<float> minX, minY, minZ;
+	std::vector<float> maxX, maxY, maxZ;
+	// frustum the bounds were built for
+	glm::mat4 boundsProjection;
+	float boundsNear, boundsFar;
+
+	// view-space center and range of every light, and the tiles and slices its bounds cover
+	struct LightBounds {
+		glm::vec4 sphere;
+		int x0, x1, y0, y1, z0, z1;
+	};
+	std::vector<LightBounds> bounds;
+	// light ids of every cluster, the threads fill interleaved slices
+	std::vector<std::vector<unsigned int> > clusterLights;
+
+	// worker threads, started by the first Update() with enough lights. They sleep between
+	// frames, the main thread takes a share of the slices as well.
+	std::vector<std::thread> workers;
+	std::mutex workMutex;
+	std::condition_variable workReady;
+	std::condition_variable workDone;
+	unsigned int workGeneration;
+	unsigned int workPending;
+	unsigned int workParts;
+	bool stopping;
+
+	// offset and count of every cluster, then the concatenated lists
+	std::vector<unsigned int> grid;
+	std::vector<unsigned int> indices;
+	unsigned int maxClusterLights;
+
+	unsigned int gridBuffer, gridTexture;
+	unsigned int indexBuffer, indexTexture;
+
+	void buildBounds(const glm::mat4 &projection, float nearPlane, float farPlane);
+	void startWorkers();
+	void workerLoop(unsigned int part);
+	// bins the lights into every slice z with z % parts == part
+	void assignSlices(unsigned int part, unsigned int parts);
+	void upload();
+};
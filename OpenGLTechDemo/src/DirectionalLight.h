@@ -1,22 +1,27 @@
 #pragma once
 #include "Light.h"
-#include "Shader.h"
+
+// std140 layout of the GLSL DirLight struct
+struct DirLightStd140 {
+	LightStd140 base;
+	glm::vec3 direction;	float pad0;
+};
+static_assert(sizeof(DirLightStd140) == 80, "DirLightStd140 must match the std140 layout of DirLight");
 
 class DirectionalLight : public Light {
 public:
-	DirectionalLight(Shader &shader);
+	DirectionalLight();
 	DirectionalLight(
-		Shader &shader,
 		glm::vec3 color,
 		glm::vec3 ambient, glm::vec3 diffuse, glm::vec3 specular,
 		glm::vec3 direction
 	);
 
-	void UseLight();
-
 	~DirectionalLight() = default;
 
 private:
+	friend class LightManager;
+
 	glm::vec3 Direction;
 };
 
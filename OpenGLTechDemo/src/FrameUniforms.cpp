@@ -0,0 +1,31 @@
+#include "FrameUniforms.h"
+
+#include <cstring>
+
+FrameUniformBuffer::FrameUniformBuffer() : ubo(0)
+{
+	std::memset(&block, 0, sizeof(block));
+}
+
+void FrameUniformBuffer::Update(const glm::mat4 &projection, const glm::mat4 &view, const ShadowCascades &cascades, const glm::vec3 &viewPos, const glm::vec4 &clusterParams)
+{
+	// initialize if necessary
+	if (ubo == 0) {
+		glGenBuffers(1, &ubo);
+		glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(block), nullptr, GL_DYNAMIC_DRAW);
+		glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_BLOCK_BINDING, ubo);
+	}
+
+	block.projection = projection;
+	block.view = view;
+	for (unsigned int i = 0; i < ShadowCascades::MAX_CASCADES; i++)
+		block.cascadeMatrices[i] = cascades.Matrices()[i];
+	block.cascadeSplits = cascades.Splits();
+	block.viewPos = viewPos;
+	block.clusterParams = clusterParams;
+
+	glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(block), &block);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
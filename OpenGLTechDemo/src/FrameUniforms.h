@@ -0,0 +1,33 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include "UniformBlocks.h"
+#include "ShadowCascades.h"
+
+// std140 layout of the FrameUniforms block shared by the scene shaders
+struct FrameUniformsStd140 {
+	glm::mat4 projection;
+	glm::mat4 view;
+	glm::mat4 cascadeMatrices[ShadowCascades::MAX_CASCADES];
+	glm::vec4 cascadeSplits;
+	glm::vec3 viewPos;
+	float pad0;
+	glm::vec4 clusterParams;
+};
+static_assert(sizeof(FrameUniformsStd140) == 432, "FrameUniformsStd140 must match the std140 layout of the FrameUniforms block");
+
+// Uniform buffer with the camera and shadow matrices of the frame, bound to FRAME_BLOCK_BINDING.
+// Update() uploads the block once per frame, every program reads it from there.
+class FrameUniformBuffer {
+public:
+	FrameUniformBuffer();
+
+	void Update(const glm::mat4 &projection, const glm::mat4 &view, const ShadowCascades &cascades, const glm::vec3 &viewPos, const glm::vec4 &clusterParams);
+
+private:
+	unsigned int ubo;
+	FrameUniformsStd140 block;
+};
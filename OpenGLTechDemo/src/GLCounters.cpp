@@ -0,0 +1,455 @@
+#include "GLCounters.h"
+
+#include <cstring>
+#include <unordered_map>
+
+#include "IMGUI/imgui.h"
+
+namespace {
+	const GLuint UNKNOWN = 0xFFFFFFFFu;
+	const unsigned int MAX_TEXTURE_UNITS = 32;
+	// texture targets tracked per unit
+	const GLenum TEXTURE_TARGETS[] = { GL_TEXTURE_2D, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BUFFER, GL_TEXTURE_3D };
+	const unsigned int TEXTURE_TARGET_COUNT = sizeof(TEXTURE_TARGETS) / sizeof(TEXTURE_TARGETS[0]);
+
+	const char* const CATEGORY_NAMES[GLCounters::CATEGORY_COUNT] = {
+		"glUniform*",
+		"glGetUniformLocation",
+		"glUseProgram",
+		"glBindTexture",
+		"glActiveTexture",
+		"glBindVertexArray",
+		"glBindBuffer",
+		"glBindFramebuffer",
+		"glBuffer(Sub)Data",
+		"glDraw*",
+		"glEnable/glDisable",
+		"glClear"
+	};
+
+	bool installed = false;
+	GLCounters::FrameCounts current;
+	GLCounters::FrameCounts last;
+
+	// shadow copy of the GL state, UNKNOWN until the first bind after Install()
+	GLuint program;
+	GLuint vertexArray;
+	GLuint drawFramebuffer;
+	GLuint readFramebuffer;
+	GLuint arrayBuffer;
+	GLuint uniformBuffer;
+	GLenum activeUnit;
+	GLuint textures[MAX_TEXTURE_UNITS][TEXTURE_TARGET_COUNT];
+	std::unordered_map<GLenum, bool> caps;
+
+	void resetState()
+	{
+		program = vertexArray = drawFramebuffer = readFramebuffer = arrayBuffer = uniformBuffer = UNKNOWN;
+		activeUnit = UNKNOWN;
+		for (unsigned int i = 0; i < MAX_TEXTURE_UNITS; i++)
+			for (unsigned int t = 0; t < TEXTURE_TARGET_COUNT; t++)
+				textures[i][t] = UNKNOWN;
+		caps.clear();
+	}
+
+	void count(GLCounters::Category category, bool redundant = false)
+	{
+		current.calls[category]++;
+		if (redundant)
+			current.redundant[category]++;
+	}
+
+	// sets the tracked value and reports whether it was already set
+	bool track(GLuint &tracked, GLuint value)
+	{
+		bool same = tracked == value;
+		tracked = value;
+		return same;
+	}
+
+	// deleting a bound object binds 0 in its place
+	void unbindDeleted(GLuint &tracked, GLsizei n, const GLuint* names)
+	{
+		for (GLsizei i = 0; i < n; i++)
+			if (names[i] != 0 && tracked == names[i])
+				tracked = 0;
+	}
+
+	unsigned long long triangles(GLenum mode, GLsizei count, GLsizei instances)
+	{
+		if (mode == GL_TRIANGLES)
+			return (unsigned long long)(count / 3) * instances;
+		if ((mode == GL_TRIANGLE_STRIP || mode == GL_TRIANGLE_FAN) && count > 2)
+			return (unsigned long long)(count - 2) * instances;
+		return 0;
+	}
+
+	// Generic counting wrapper: one instantiation per wrapped function (Id), holding the original
+	// pointer. Used for calls that only need counting.
+	template <int Id, typename Ret, typename... Args>
+	struct Counted {
+		static Ret (APIENTRYP real)(Args...);
+		static Ret (APIENTRYP *slot)(Args...);
+		static GLCounters::Category category;
+
+		static Ret APIENTRY call(Args... args)
+		{
+			count(category);
+			return real(args...);
+		}
+	};
+	template <int Id, typename Ret, typename... Args> Ret (APIENTRYP Counted<Id, Ret, Args...>::real)(Args...) = nullptr;
+	template <int Id, typename Ret, typename... Args> Ret (APIENTRYP *Counted<Id, Ret, Args...>::slot)(Args...) = nullptr;
+	template <int Id, typename Ret, typename... Args> GLCounters::Category Counted<Id, Ret, Args...>::category;
+
+	// restores every wrapped pointer on Uninstall()
+	typedef void (*RestoreFunc)();
+	RestoreFunc restoreFuncs[64];
+	unsigned int restoreCount = 0;
+
+	template <int Id, typename Ret, typename... Args>
+	void restore()
+	{
+		*Counted<Id, Ret, Args...>::slot = Counted<Id, Ret, Args...>::real;
+	}
+
+	template <int Id, typename Ret, typename... Args>
+	void wrap(Ret (APIENTRYP &pointer)(Args...), Ret (APIENTRYP replacement)(Args...), GLCounters::Category category)
+	{
+		if (pointer == nullptr)
+			return;
+		Counted<Id, Ret, Args...>::real = pointer;
+		Counted<Id, Ret, Args...>::slot = &pointer;
+		Counted<Id, Ret, Args...>::category = category;
+		pointer = replacement;
+		restoreFuncs[restoreCount++] = &restore<Id, Ret, Args...>;
+	}
+
+	template <int Id, typename Ret, typename... Args>
+	void wrap(Ret (APIENTRYP &pointer)(Args...), GLCounters::Category category)
+	{
+		wrap<Id>(pointer, &Counted<Id, Ret, Args...>::call, category);
+	}
+
+// wraps glad_<name> with the plain counting wrapper
+#define COUNT_CALLS(name, category) wrap<__LINE__>(glad_##name, category)
+// wraps glad_<name> with counted_<name> below, which reaches the driver through real_<name>
+#define TRACK_CALLS(name, category) real_##name = glad_##name; wrap<__LINE__>(glad_##name, &counted_##name, category)
+
+	PFNGLUSEPROGRAMPROC real_glUseProgram;
+	PFNGLBINDTEXTUREPROC real_glBindTexture;
+	PFNGLACTIVETEXTUREPROC real_glActiveTexture;
+	PFNGLBINDVERTEXARRAYPROC real_glBindVertexArray;
+	PFNGLBINDBUFFERPROC real_glBindBuffer;
+	PFNGLBINDBUFFERBASEPROC real_glBindBufferBase;
+	PFNGLBINDBUFFERRANGEPROC real_glBindBufferRange;
+	PFNGLBINDFRAMEBUFFERPROC real_glBindFramebuffer;
+	PFNGLDELETEBUFFERSPROC real_glDeleteBuffers;
+	PFNGLDELETETEXTURESPROC real_glDeleteTextures;
+	PFNGLDELETEVERTEXARRAYSPROC real_glDeleteVertexArrays;
+	PFNGLDELETEFRAMEBUFFERSPROC real_glDeleteFramebuffers;
+	PFNGLBUFFERDATAPROC real_glBufferData;
+	PFNGLBUFFERSUBDATAPROC real_glBufferSubData;
+	PFNGLDRAWARRAYSPROC real_glDrawArrays;
+	PFNGLDRAWELEMENTSPROC real_glDrawElements;
+	PFNGLDRAWARRAYSINSTANCEDPROC real_glDrawArraysInstanced;
+	PFNGLDRAWELEMENTSINSTANCEDPROC real_glDrawElementsInstanced;
+	PFNGLENABLEPROC real_glEnable;
+	PFNGLDISABLEPROC real_glDisable;
+
+	void APIENTRY counted_glUseProgram(GLuint id)
+	{
+		count(GLCounters::USE_PROGRAM, track(program, id));
+		real_glUseProgram(id);
+	}
+
+	void APIENTRY counted_glBindTexture(GLenum target, GLuint texture)
+	{
+		bool redundant = false;
+		if (activeUnit != UNKNOWN && activeUnit - GL_TEXTURE0 < MAX_TEXTURE_UNITS)
+			for (unsigned int t = 0; t < TEXTURE_TARGET_COUNT; t++)
+				if (TEXTURE_TARGETS[t] == target)
+					redundant = track(textures[activeUnit - GL_TEXTURE0][t], texture);
+		count(GLCounters::BIND_TEXTURE, redundant);
+		real_glBindTexture(target, texture);
+	}
+
+	void APIENTRY counted_glActiveTexture(GLenum unit)
+	{
+		count(GLCounters::ACTIVE_TEXTURE, track(activeUnit, unit));
+		real_glActiveTexture(unit);
+	}
+
+	void APIENTRY counted_glBindVertexArray(GLuint id)
+	{
+		count(GLCounters::BIND_VERTEX_ARRAY, track(vertexArray, id));
+		real_glBindVertexArray(id);
+	}
+
+	void APIENTRY counted_glBindBuffer(GLenum target, GLuint buffer)
+	{
+		// element array bindings belong to the vertex array, they are only counted
+		bool redundant = false;
+		if (target == GL_ARRAY_BUFFER)
+			redundant = track(arrayBuffer, buffer);
+		else if (target == GL_UNIFORM_BUFFER)
+			redundant = track(uniformBuffer, buffer);
+		count(GLCounters::BIND_BUFFER, redundant);
+		real_glBindBuffer(target, buffer);
+	}
+
+	// indexed binds are never redundant as far as we track, but they also set the generic binding
+	void APIENTRY counted_glBindBufferBase(GLenum target, GLuint index, GLuint buffer)
+	{
+		if (target == GL_UNIFORM_BUFFER)
+			uniformBuffer = buffer;
+		count(GLCounters::BIND_BUFFER);
+		real_glBindBufferBase(target, index, buffer);
+	}
+
+	void APIENTRY counted_glBindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+	{
+		if (target == GL_UNIFORM_BUFFER)
+			uniformBuffer = buffer;
+		count(GLCounters::BIND_BUFFER);
+		real_glBindBufferRange(target, index, buffer, offset, size);
+	}
+
+	void APIENTRY counted_glBindFramebuffer(GLenum target, GLuint framebuffer)
+	{
+		bool redundant;
+		if (target == GL_READ_FRAMEBUFFER)
+			redundant = track(readFramebuffer, framebuffer);
+		else if (target == GL_DRAW_FRAMEBUFFER)
+			redundant = track(drawFramebuffer, framebuffer);
+		else
+			redundant = track(drawFramebuffer, framebuffer) & track(readFramebuffer, framebuffer);
+		count(GLCounters::BIND_FRAMEBUFFER, redundant);
+		real_glBindFramebuffer(target, framebuffer);
+	}
+
+	void APIENTRY counted_glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+	{
+		count(GLCounters::BUFFER_UPLOAD);
+		current.uploadBytes += size;
+		real_glBufferData(target, size, data, usage);
+	}
+
+	void APIENTRY counted_glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+	{
+		count(GLCounters::BUFFER_UPLOAD);
+		current.uploadBytes += size;
+		real_glBufferSubData(target, offset, size, data);
+	}
+
+	void APIENTRY counted_glDrawArrays(GLenum mode, GLint first, GLsizei vertices)
+	{
+		count(GLCounters::DRAW);
+		current.triangles += triangles(mode, vertices, 1);
+		real_glDrawArrays(mode, first, vertices);
+	}
+
+	void APIENTRY counted_glDrawElements(GLenum mode, GLsizei indices, GLenum type, const void* offset)
+	{
+		count(GLCounters::DRAW);
+		current.triangles += triangles(mode, indices, 1);
+		real_glDrawElements(mode, indices, type, offset);
+	}
+
+	void APIENTRY counted_glDrawArraysInstanced(GLenum mode, GLint first, GLsizei vertices, GLsizei instances)
+	{
+		count(GLCounters::DRAW);
+		current.triangles += triangles(mode, vertices, instances);
+		real_glDrawArraysInstanced(mode, first, vertices, instances);
+	}
+
+	void APIENTRY counted_glDrawElementsInstanced(GLenum mode, GLsizei indices, GLenum type, const void* offset, GLsizei instances)
+	{
+		count(GLCounters::DRAW);
+		current.triangles += triangles(mode, indices, instances);
+		real_glDrawElementsInstanced(mode, indices, type, offset, instances);
+	}
+
+	// deletes are not counted, they only keep the tracked bindings right
+	void APIENTRY counted_glDeleteBuffers(GLsizei n, const GLuint* buffers)
+	{
+		unbindDeleted(arrayBuffer, n, buffers);
+		unbindDeleted(uniformBuffer, n, buffers);
+		real_glDeleteBuffers(n, buffers);
+	}
+
+	void APIENTRY counted_glDeleteTextures(GLsizei n, const GLuint* names)
+	{
+		for (unsigned int i = 0; i < MAX_TEXTURE_UNITS; i++)
+			for (unsigned int t = 0; t < TEXTURE_TARGET_COUNT; t++)
+				unbindDeleted(textures[i][t], n, names);
+		real_glDeleteTextures(n, names);
+	}
+
+	void APIENTRY counted_glDeleteVertexArrays(GLsizei n, const GLuint* arrays)
+	{
+		unbindDeleted(vertexArray, n, arrays);
+		real_glDeleteVertexArrays(n, arrays);
+	}
+
+	void APIENTRY counted_glDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+	{
+		unbindDeleted(drawFramebuffer, n, framebuffers);
+		unbindDeleted(readFramebuffer, n, framebuffers);
+		real_glDeleteFramebuffers(n, framebuffers);
+	}
+
+	bool trackCap(GLenum cap, bool enabled)
+	{
+		std::unordered_map<GLenum, bool>::iterator it = caps.find(cap);
+		bool same = it != caps.end() && it->second == enabled;
+		caps[cap] = enabled;
+		return same;
+	}
+
+	void APIENTRY counted_glEnable(GLenum cap)
+	{
+		count(GLCounters::ENABLE_DISABLE, trackCap(cap, true));
+		real_glEnable(cap);
+	}
+
+	void APIENTRY counted_glDisable(GLenum cap)
+	{
+		count(GLCounters::ENABLE_DISABLE, trackCap(cap, false));
+		real_glDisable(cap);
+	}
+}
+
+void GLCounters::Install()
+{
+	if (installed)
+		return;
+
+	std::memset(&current, 0, sizeof(current));
+	std::memset(&last, 0, sizeof(last));
+	resetState();
+	restoreCount = 0;
+
+	COUNT_CALLS(glUniform1f, UNIFORM);
+	COUNT_CALLS(glUniform2f, UNIFORM);
+	COUNT_CALLS(glUniform3f, UNIFORM);
+	COUNT_CALLS(glUniform4f, UNIFORM);
+	COUNT_CALLS(glUniform1i, UNIFORM);
+	COUNT_CALLS(glUniform2i, UNIFORM);
+	COUNT_CALLS(glUniform3i, UNIFORM);
+	COUNT_CALLS(glUniform4i, UNIFORM);
+	COUNT_CALLS(glUniform1fv, UNIFORM);
+	COUNT_CALLS(glUniform2fv, UNIFORM);
+	COUNT_CALLS(glUniform3fv, UNIFORM);
+	COUNT_CALLS(glUniform4fv, UNIFORM);
+	COUNT_CALLS(glUniform1iv, UNIFORM);
+	COUNT_CALLS(glUniformMatrix2fv, UNIFORM);
+	COUNT_CALLS(glUniformMatrix3fv, UNIFORM);
+	COUNT_CALLS(glUniformMatrix4fv, UNIFORM);
+	COUNT_CALLS(glGetUniformLocation, GET_UNIFORM_LOCATION);
+	COUNT_CALLS(glClear, CLEAR);
+
+	TRACK_CALLS(glUseProgram, USE_PROGRAM);
+	TRACK_CALLS(glBindTexture, BIND_TEXTURE);
+	TRACK_CALLS(glActiveTexture, ACTIVE_TEXTURE);
+	TRACK_CALLS(glBindVertexArray, BIND_VERTEX_ARRAY);
+	TRACK_CALLS(glBindBuffer, BIND_BUFFER);
+	TRACK_CALLS(glBindBufferBase, BIND_BUFFER);
+	TRACK_CALLS(glBindBufferRange, BIND_BUFFER);
+	TRACK_CALLS(glBindFramebuffer, BIND_FRAMEBUFFER);
+	TRACK_CALLS(glBufferData, BUFFER_UPLOAD);
+	TRACK_CALLS(glBufferSubData, BUFFER_UPLOAD);
+	TRACK_CALLS(glDrawArrays, DRAW);
+	TRACK_CALLS(glDrawElements, DRAW);
+	TRACK_CALLS(glDrawArraysInstanced, DRAW);
+	TRACK_CALLS(glDrawElementsInstanced, DRAW);
+	TRACK_CALLS(glEnable, ENABLE_DISABLE);
+	TRACK_CALLS(glDisable, ENABLE_DISABLE);
+	TRACK_CALLS(glDeleteBuffers, BIND_BUFFER);
+	TRACK_CALLS(glDeleteTextures, BIND_TEXTURE);
+	TRACK_CALLS(glDeleteVertexArrays, BIND_VERTEX_ARRAY);
+	TRACK_CALLS(glDeleteFramebuffers, BIND_FRAMEBUFFER);
+
+	installed = true;
+}
+
+void GLCounters::Uninstall()
+{
+	if (!installed)
+		return;
+
+	for (unsigned int i = 0; i < restoreCount; i++)
+		restoreFuncs[i]();
+	restoreCount = 0;
+	installed = false;
+}
+
+bool GLCounters::Installed()
+{
+	return installed;
+}
+
+void GLCounters::BeginFrame()
+{
+	std::memset(&current, 0, sizeof(current));
+}
+
+void GLCounters::EndFrame()
+{
+	if (installed)
+		last = current;
+}
+
+const GLCounters::FrameCounts& GLCounters::LastFrame()
+{
+	return last;
+}
+
+const char* GLCounters::CategoryName(Category category)
+{
+	return CATEGORY_NAMES[category];
+}
+
+void GLCounters::DrawImGui()
+{
+	ImGui::Begin("GL Calls");
+
+	bool enabled = installed;
+	if (ImGui::Checkbox("Count GL calls", &enabled)) {
+		if (enabled)
+			Install();
+		else
+			Uninstall();
+	}
+
+	if (installed && ImGui::BeginTable("glcalls", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV)) {
+		ImGui::TableSetupColumn("Call");
+		ImGui::TableSetupColumn("per frame");
+		ImGui::TableSetupColumn("redundant");
+		ImGui::TableHeadersRow();
+
+		for (int i = 0; i < CATEGORY_COUNT; i++) {
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(CATEGORY_NAMES[i]);
+			ImGui::TableNextColumn();
+			ImGui::Text("%u", last.calls[i]);
+			ImGui::TableNextColumn();
+			if (last.redundant[i] > 0)
+				ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "%u", last.redundant[i]);
+		}
+		ImGui::EndTable();
+
+		ImGui::Text("%llu triangles, %llu bytes uploaded", last.triangles, last.uploadBytes);
+	}
+
+	ImGui::End();
+}
+
+void GLCounters::WriteJson(std::ostream &out, const FrameCounts &counts)
+{
+	out << "{";
+	for (int i = 0; i < CATEGORY_COUNT; i++)
+		out << (i ? ", " : "") << "\"" << CATEGORY_NAMES[i] << "\": {\"calls\": " << counts.calls[i] << ", \"redundant\": " << counts.redundant[i] << "}";
+	out << ", \"triangles\": " << counts.triangles << ", \"upload_bytes\": " << counts.uploadBytes << "}";
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <ostream>
+
+// Optional instrumentation of the GL dispatch: Install() swaps the glad function pointers of the
+// calls below for wrappers that count them per frame, and tracks the bound program, vertex array,
+// framebuffer, buffers, textures and enabled caps to flag binds that change nothing. Deleting a
+// bound object is tracked as binding 0.
+// Uninstall() restores the original pointers. Counting is single threaded, like our GL use.
+namespace GLCounters {
+	enum Category {
+		UNIFORM,
+		GET_UNIFORM_LOCATION,
+		USE_PROGRAM,
+		BIND_TEXTURE,
+		ACTIVE_TEXTURE,
+		BIND_VERTEX_ARRAY,
+		BIND_BUFFER,
+		BIND_FRAMEBUFFER,
+		BUFFER_UPLOAD,
+		DRAW,
+		ENABLE_DISABLE,
+		CLEAR,
+		CATEGORY_COUNT
+	};
+
+	struct FrameCounts {
+		unsigned int calls[CATEGORY_COUNT];
+		// calls that set the state to what it already was
+		unsigned int redundant[CATEGORY_COUNT];
+		unsigned long long uploadBytes;
+		unsigned long long triangles;
+	};
+
+	// must be called after gladLoadGLLoader
+	void Install();
+	void Uninstall();
+	bool Installed();
+
+	void BeginFrame();
+	void EndFrame();
+	// counts of the last finished frame
+	const FrameCounts& LastFrame();
+
+	const char* CategoryName(Category category);
+
+	// "GL Calls" window with the counts of the last frame and a switch to install the layer
+	void DrawImGui();
+	// JSON object with the calls and redundant calls of every category
+	void WriteJson(std::ostream &out, const FrameCounts &counts);
+}
@@ -0,0 +1,232 @@
+#include "GpuProfiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#include "IMGUI/imgui.h"
+
+namespace {
+	const unsigned int NO_PASS = 0xFFFFFFFFu;
+
+	// value at percentile p (0-100) of the samples
+	float percentile(std::vector<float> samples, float p)
+	{
+		if (samples.empty())
+			return 0.0f;
+		std::sort(samples.begin(), samples.end());
+		size_t index = (size_t)(p / 100.0f * (samples.size() - 1) + 0.5f);
+		return samples[std::min(index, samples.size() - 1)];
+	}
+
+	float average(const std::vector<float> &samples)
+	{
+		float sum = 0.0f;
+		for (size_t i = 0; i < samples.size(); i++)
+			sum += samples[i];
+		return samples.empty() ? 0.0f : sum / samples.size();
+	}
+}
+
+GpuProfiler::GpuProfiler() : frameNumber(0), initialized(false), paused(false)
+{
+}
+
+void GpuProfiler::init()
+{
+	for (unsigned int i = 0; i < FRAMES_IN_FLIGHT; i++) {
+		glGenQueries(1, &frames[i].frameQuery);
+		glGenQueries(MAX_PASSES * 2, frames[i].timestamps);
+		frames[i].usedTimestamps = 0;
+		frames[i].frameNumber = 0;
+		frames[i].pending = false;
+	}
+	initialized = true;
+}
+
+void GpuProfiler::BeginFrame()
+{
+	if (!initialized)
+		init();
+
+	// read back every older frame whose queries have landed, oldest first
+	for (unsigned int i = 1; i <= FRAMES_IN_FLIGHT; i++) {
+		QueryFrame &older = frames[(frameNumber + i) % FRAMES_IN_FLIGHT];
+		if (older.pending)
+			resolve(older);
+	}
+
+	frameNumber++;
+	QueryFrame &frame = frames[frameNumber % FRAMES_IN_FLIGHT];
+	// still not available after FRAMES_IN_FLIGHT frames: drop it rather than wait for the GPU
+	frame.pending = false;
+	frame.usedTimestamps = 0;
+	frame.passes.clear();
+	frame.frameNumber = frameNumber;
+	passStack.clear();
+
+	glBeginQuery(GL_TIME_ELAPSED, frame.frameQuery);
+}
+
+void GpuProfiler::EndFrame()
+{
+	QueryFrame &frame = frames[frameNumber % FRAMES_IN_FLIGHT];
+	glEndQuery(GL_TIME_ELAPSED);
+	frame.pending = true;
+}
+
+void GpuProfiler::BeginPass(const char* name)
+{
+	QueryFrame &frame = frames[frameNumber % FRAMES_IN_FLIGHT];
+	if (!initialized || frame.usedTimestamps + 2 > MAX_PASSES * 2) {
+		passStack.push_back(NO_PASS);
+		return;
+	}
+
+	Pass pass;
+	pass.id = passId(name);
+	pass.beginQuery = frame.timestamps[frame.usedTimestamps++];
+	pass.endQuery = frame.timestamps[frame.usedTimestamps++];
+	glQueryCounter(pass.beginQuery, GL_TIMESTAMP);
+
+	passStack.push_back((unsigned int)frame.passes.size());
+	frame.passes.push_back(pass);
+}
+
+void GpuProfiler::EndPass()
+{
+	if (passStack.empty())
+		return;
+
+	unsigned int index = passStack.back();
+	passStack.pop_back();
+	if (index == NO_PASS)
+		return;
+
+	QueryFrame &frame = frames[frameNumber % FRAMES_IN_FLIGHT];
+	glQueryCounter(frame.passes[index].endQuery, GL_TIMESTAMP);
+}
+
+unsigned int GpuProfiler::passId(const char* name)
+{
+	std::string path = name;
+	unsigned int depth = 0;
+	for (size_t i = passStack.size(); i-- > 0;) {
+		if (passStack[i] == NO_PASS)
+			continue;
+		const QueryFrame &frame = frames[frameNumber % FRAMES_IN_FLIGHT];
+		path = passInfos[frame.passes[passStack[i]].id].path + '/' + path;
+		depth = passInfos[frame.passes[passStack[i]].id].depth + 1;
+		break;
+	}
+
+	for (size_t i = 0; i < passInfos.size(); i++)
+		if (passInfos[i].path == path)
+			return (unsigned int)i;
+
+	PassInfo info;
+	info.path = path;
+	info.name = name;
+	info.depth = depth;
+	passInfos.push_back(info);
+	return (unsigned int)passInfos.size() - 1;
+}
+
+void GpuProfiler::resolve(QueryFrame &frame)
+{
+	GLint available = 0;
+	glGetQueryObjectiv(frame.frameQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+	if (available && frame.usedTimestamps > 0)
+		glGetQueryObjectiv(frame.timestamps[frame.usedTimestamps - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+	if (!available)
+		return;
+
+	frame.pending = false;
+	if (paused)
+		return;
+
+	FrameResult result;
+	result.frameNumber = frame.frameNumber;
+	GLuint64 elapsed = 0;
+	glGetQueryObjectui64v(frame.frameQuery, GL_QUERY_RESULT, &elapsed);
+	result.frameMs = elapsed / 1000000.0f;
+
+	result.passMs.assign(passInfos.size(), -1.0f);
+	for (size_t i = 0; i < frame.passes.size(); i++) {
+		GLuint64 begin = 0, end = 0;
+		glGetQueryObjectui64v(frame.passes[i].beginQuery, GL_QUERY_RESULT, &begin);
+		glGetQueryObjectui64v(frame.passes[i].endQuery, GL_QUERY_RESULT, &end);
+		float &ms = result.passMs[frame.passes[i].id];
+		ms = std::max(ms, 0.0f) + (end - begin) / 1000000.0f;
+	}
+
+	history.push_back(result);
+	if (history.size() > HISTORY_SIZE)
+		history.pop_front();
+}
+
+void GpuProfiler::DrawImGui()
+{
+	ImGui::Begin("GPU Profiler");
+
+	size_t first = history.size() > STATS_WINDOW ? history.size() - STATS_WINDOW : 0;
+	std::vector<float> frameSamples;
+	for (size_t i = first; i < history.size(); i++)
+		frameSamples.push_back(history[i].frameMs);
+
+	ImGui::Text("GPU frame %.3f ms (p95 %.3f, p99 %.3f) over %d frames", average(frameSamples), percentile(frameSamples, 95.0f), percentile(frameSamples, 99.0f), (int)frameSamples.size());
+	ImGui::Checkbox("Pause", &paused);
+	ImGui::SameLine();
+	if (ImGui::Button("Dump CSV"))
+		DumpCsv("gpu_profile.csv");
+
+	if (ImGui::BeginTable("passes", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV)) {
+		ImGui::TableSetupColumn("Pass");
+		ImGui::TableSetupColumn("avg ms");
+		ImGui::TableSetupColumn("p95 ms");
+		ImGui::TableSetupColumn("p99 ms");
+		ImGui::TableHeadersRow();
+
+		for (size_t p = 0; p < passInfos.size(); p++) {
+			std::vector<float> samples;
+			for (size_t i = first; i < history.size(); i++)
+				if (p < history[i].passMs.size() && history[i].passMs[p] >= 0.0f)
+					samples.push_back(history[i].passMs[p]);
+			if (samples.empty())
+				continue;
+
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::Text("%*s%s", passInfos[p].depth * 2, "", passInfos[p].name.c_str());
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", average(samples));
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", percentile(samples, 95.0f));
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", percentile(samples, 99.0f));
+		}
+		ImGui::EndTable();
+	}
+
+	ImGui::End();
+}
+
+bool GpuProfiler::DumpCsv(const std::string &path) const
+{
+	std::ofstream out(path.c_str());
+	if (!out) {
+		std::cout << "Error::GpuProfiler: could not write " << path << std::endl;
+		return false;
+	}
+
+	out << "frame,pass,gpu_ms\n";
+	for (size_t i = 0; i < history.size(); i++) {
+		out << history[i].frameNumber << ",frame," << history[i].frameMs << "\n";
+		for (size_t p = 0; p < history[i].passMs.size(); p++)
+			if (history[i].passMs[p] >= 0.0f)
+				out << history[i].frameNumber << "," << passInfos[p].path << "," << history[i].passMs[p] << "\n";
+	}
+
+	std::cout << "GpuProfiler: wrote " << history.size() << " frames to " << path << std::endl;
+	return true;
+}
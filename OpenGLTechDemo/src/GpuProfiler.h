@@ -0,0 +1,73 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+// Measures GPU time of nested render passes with GL_TIMESTAMP queries and the whole frame with
+// GL_TIME_ELAPSED. Queries are recycled through a ring of frames, so results are read a few
+// frames later, once they are available, instead of stalling the pipeline.
+class GpuProfiler {
+public:
+	GpuProfiler();
+
+	void BeginFrame();
+	void EndFrame();
+
+	void BeginPass(const char* name);
+	void EndPass();
+
+	// "GPU Profiler" window with rolling average, p95 and p99 of every pass
+	void DrawImGui();
+	// writes frame,pass,ms rows for every frame still in the history
+	bool DumpCsv(const std::string &path) const;
+
+private:
+	static const unsigned int FRAMES_IN_FLIGHT = 4;
+	static const unsigned int MAX_PASSES = 128;
+	static const unsigned int HISTORY_SIZE = 600;
+	// frames used for the on screen statistics
+	static const unsigned int STATS_WINDOW = 240;
+
+	struct Pass {
+		unsigned int id;
+		unsigned int beginQuery;
+		unsigned int endQuery;
+	};
+
+	struct QueryFrame {
+		unsigned int frameQuery;
+		unsigned int timestamps[MAX_PASSES * 2];
+		unsigned int usedTimestamps;
+		std::vector<Pass> passes;
+		unsigned long long frameNumber;
+		bool pending;
+	};
+
+	struct FrameResult {
+		unsigned long long frameNumber;
+		float frameMs;
+		// time of every pass, indexed by pass id, negative if the pass did not run
+		std::vector<float> passMs;
+	};
+
+	struct PassInfo {
+		std::string path;
+		std::string name;
+		unsigned int depth;
+	};
+
+	QueryFrame frames[FRAMES_IN_FLIGHT];
+	unsigned long long frameNumber;
+	std::vector<unsigned int> passStack;
+	std::vector<PassInfo> passInfos;
+	std::deque<FrameResult> history;
+	bool initialized;
+	bool paused;
+
+	void init();
+	void resolve(QueryFrame &frame);
+	unsigned int passId(const char* name);
+};
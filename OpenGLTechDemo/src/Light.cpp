@@ -1,18 +1,41 @@
 #include "Light.h"
 
-Light::Light(Shader &shader)
+#include <algorithm>
+
+namespace {
+	float maxComponent(const glm::vec3 &v)
+	{
+		return std::max(v.x, std::max(v.y, v.z));
+	}
+}
+
+Light::Light()
 {
-	this->shader = shader;
 	Color		= glm::vec3(1.0f);
 	Ambient		= glm::vec3(1.0f);
 	Diffuse		= glm::vec3(0.0f);
+	Specular	= glm::vec3(0.0f);
 }
 
-Light::Light(Shader &shader, glm::vec3 color, glm::vec3 ambient, glm::vec3 diffuse, glm::vec3 specular)
+Light::Light(glm::vec3 color, glm::vec3 ambient, glm::vec3 diffuse, glm::vec3 specular)
 {
-	this->shader = shader;
 	Color		= color;
 	Ambient		= ambient;
 	Diffuse		= diffuse;
 	Specular	= specular;
-}
\ No newline at end of file
+}
+
+void Light::SetColor(glm::vec3 color)
+{
+	Color = color;
+}
+
+float Light::Peak() const
+{
+	return Peak(Color, Ambient, Diffuse, Specular);
+}
+
+float Light::Peak(const glm::vec3 &color, const glm::vec3 &ambient, const glm::vec3 &diffuse, const glm::vec3 &specular)
+{
+	return maxComponent(color) * (maxComponent(ambient) + maxComponent(diffuse) + maxComponent(specular));
+}
@@ -1,18 +1,33 @@
 #pragma once
-#include <glad\glad.h>
-#include <glm\glm.hpp>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
 
-#include "Shader.h"
+// std140 layout of the GLSL Light struct, every vec3 takes 16 bytes
+struct LightStd140 {
+	glm::vec3 color;	float pad0;
+	glm::vec3 ambient;	float pad1;
+	glm::vec3 diffuse;	float pad2;
+	glm::vec3 specular;	float pad3;
+};
+static_assert(sizeof(LightStd140) == 64, "LightStd140 must match the std140 layout of Light");
 
 class Light {
 public:
-	Light(Shader &shader);
-	Light(Shader &shader, glm::vec3 color, glm::vec3 ambient, glm::vec3 diffuse , glm::vec3 specular);
+	Light();
+	Light(glm::vec3 color, glm::vec3 ambient, glm::vec3 diffuse , glm::vec3 specular);
+
+	void SetColor(glm::vec3 color);
+
+	// brightest color component times the summed intensities, the light's value at distance 0
+	float Peak() const;
+	static float Peak(const glm::vec3 &color, const glm::vec3 &ambient, const glm::vec3 &diffuse, const glm::vec3 &specular);
 
 	~Light() = default;
 
 protected:
-	Shader shader;
+	// LightManager copies lights into its arrays
+	friend class LightManager;
+
 	glm::vec3 Color;
 	glm::vec3 Ambient;
 	glm::vec3 Diffuse;
@@ -0,0 +1,20 @@
+#include "LightBuffer.h"
+
+LightBuffer::LightBuffer() : ubo(0)
+{
+}
+
+void LightBuffer::Update(const LightBlockStd140 &block, unsigned int offset, unsigned int size)
+{
+	// initialize if necessary
+	if (ubo == 0) {
+		glGenBuffers(1, &ubo);
+		glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(block), nullptr, GL_DYNAMIC_DRAW);
+		glBindBufferBase(GL_UNIFORM_BUFFER, LIGHTS_BLOCK_BINDING, ubo);
+	}
+
+	glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+	glBufferSubData(GL_UNIFORM_BUFFER, offset, size, (const char*)&block + offset);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "DirectionalLight.h"
+#include "PointLight.h"
+#include "SpotLight.h"
+#include "UniformBlocks.h"
+
+// std140 layout of the Lights uniform block in lighting.frag and modelShader.frag
+struct LightBlockStd140 {
+	static const unsigned int MAX_POINT_LIGHTS = 4;
+	static const unsigned int MAX_SPOT_LIGHTS = 1;
+
+	DirLightStd140 dirLight;
+	PointLightStd140 pointLights[MAX_POINT_LIGHTS];
+	SpotLightStd140 spotLights[MAX_SPOT_LIGHTS];
+};
+static_assert(sizeof(LightBlockStd140) == 592, "LightBlockStd140 must match the std140 layout of the Lights block");
+
+// Uniform buffer holding every light of the scene, bound to LIGHTS_BLOCK_BINDING.
+// Filled by LightManager, which only uploads the lights that changed.
+class LightBuffer {
+public:
+	LightBuffer();
+
+	// uploads size bytes of the block starting at offset with one glBufferSubData
+	void Update(const LightBlockStd140 &block, unsigned int offset, unsigned int size);
+
+private:
+	unsigned int ubo;
+};
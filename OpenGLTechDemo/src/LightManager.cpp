@@ -0,0 +1,312 @@
+#include "LightManager.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+#include "Profiler.h"
+
+LightManager::LightManager()
+	: pointCount(0), spotCount(0), dirtySlots(0), firstDirty(0), lastDirty(0), uploadedLights(0), uploadedBytes(0),
+	lightBuffer(0), lightTexture(0), lightCapacity(0)
+{
+	std::memset(&dirLight, 0, sizeof(dirLight));
+	std::memset(&block, 0, sizeof(block));
+	for (unsigned int i = 0; i < SLOT_COUNT; i++)
+		slotLight[i] = NO_SLOT;
+}
+
+void LightManager::SetDirectionalLight(const DirectionalLight &light)
+{
+	dirLight.base.color = light.Color;
+	dirLight.base.ambient = light.Ambient;
+	dirLight.base.diffuse = light.Diffuse;
+	dirLight.base.specular = light.Specular;
+	dirLight.direction = light.Direction;
+	dirtySlots |= 1u << DIR_SLOT;
+}
+
+unsigned int LightManager::AddPointLight(const PointLight &light)
+{
+	int lightSlot = pointCount < MAX_POINT_LIGHTS ? (int)(1 + pointCount) : NO_SLOT;
+	pointCount++;
+	return addLight(light, light.Position, glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(light.Constant, light.Linear, light.Quadratic), glm::vec2(-1.0f, -2.0f), lightSlot, false);
+}
+
+unsigned int LightManager::AddSpotLight(const SpotLight &light)
+{
+	int lightSlot = spotCount < MAX_SPOT_LIGHTS ? (int)(1 + MAX_POINT_LIGHTS + spotCount) : NO_SLOT;
+	spotCount++;
+	return addLight(light, light.Position, light.Direction, glm::vec3(light.Constant, light.Linear, light.Quadratic), glm::vec2(light.Edge, light.ProcEdge), lightSlot, true);
+}
+
+void LightManager::Truncate(unsigned int count)
+{
+	if (count >= Count())
+		return;
+
+	// lights keep their slots, so the next ones added fill the freed slots in order
+	for (unsigned int i = count; i < Count(); i++) {
+		if (spot[i])
+			spotCount--;
+		else
+			pointCount--;
+		if (slot[i] != NO_SLOT)
+			slotLight[slot[i]] = NO_SLOT;
+	}
+
+	color.resize(count);
+	ambient.resize(count);
+	diffuse.resize(count);
+	specular.resize(count);
+	position.resize(count);
+	direction.resize(count);
+	attenuation.resize(count);
+	cutOff.resize(count);
+	range.resize(count);
+	slot.resize(count);
+	spot.resize(count);
+	dirty.resize(count);
+	texels.resize(count * TEXELS_PER_LIGHT);
+	firstDirty = std::min(firstDirty, count);
+	lastDirty = std::min(lastDirty, count);
+}
+
+void LightManager::SetPosition(unsigned int light, const glm::vec3 &newPosition)
+{
+	if (light >= Count() || position[light] == newPosition)
+		return;
+	position[light] = newPosition;
+	markDirty(light);
+}
+
+void LightManager::SetColor(unsigned int light, const glm::vec3 &newColor)
+{
+	if (light >= Count() || color[light] == newColor)
+		return;
+	color[light] = newColor;
+	updateRange(light);
+	markDirty(light);
+}
+
+void LightManager::SetDirection(unsigned int light, const glm::vec3 &newDirection)
+{
+	if (light >= Count() || direction[light] == newDirection)
+		return;
+	direction[light] = newDirection;
+	markDirty(light);
+}
+
+void LightManager::BlockLights(DrawLights &out) const
+{
+	out.pointCount = out.spotCount = 0;
+	for (unsigned int i = 0; i < MAX_POINT_LIGHTS; i++)
+		if (slotLight[1 + i] != NO_SLOT)
+			out.pointLights[out.pointCount++] = (int)i;
+	for (unsigned int i = 0; i < MAX_SPOT_LIGHTS; i++)
+		if (slotLight[1 + MAX_POINT_LIGHTS + i] != NO_SLOT)
+			out.spotLights[out.spotCount++] = (int)i;
+}
+
+void LightManager::CullBlockLights(const DrawLights &candidates, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax, DrawLights &out) const
+{
+	// counts are read first, so compacting in place only ever writes behind the read position
+	unsigned int pointCandidates = candidates.pointCount, spotCandidates = candidates.spotCount;
+	unsigned int points = 0, spots = 0;
+	for (unsigned int i = 0; i < pointCandidates; i++) {
+		int index = candidates.pointLights[i];
+		if (touches(slotLight[1 + index], boundsMin, boundsMax))
+			out.pointLights[points++] = index;
+	}
+	for (unsigned int i = 0; i < spotCandidates; i++) {
+		int index = candidates.spotLights[i];
+		if (touches(slotLight[1 + MAX_POINT_LIGHTS + index], boundsMin, boundsMax))
+			out.spotLights[spots++] = index;
+	}
+	out.pointCount = points;
+	out.spotCount = spots;
+}
+
+void LightManager::Upload()
+{
+	PROFILE_FUNCTION();
+
+	uploadedLights = uploadedBytes = 0;
+	for (unsigned int i = firstDirty; i < lastDirty; i++) {
+		if (!dirty[i])
+			continue;
+		if (slot[i] != NO_SLOT) {
+			packSlot(slot[i], i);
+			dirtySlots |= 1u << slot[i];
+		}
+		packTexels(i);
+		uploadedLights++;
+	}
+
+	uploadSlots();
+	uploadTexels();
+
+	std::fill(dirty.begin() + firstDirty, dirty.begin() + lastDirty, 0);
+	firstDirty = lastDirty = 0;
+}
+
+unsigned int LightManager::addLight(const Light &light, const glm::vec3 &lightPosition, const glm::vec3 &lightDirection, const glm::vec3 &lightAttenuation, const glm::vec2 &lightCutOff, int lightSlot, bool isSpot)
+{
+	unsigned int id = Count();
+	color.push_back(light.Color);
+	ambient.push_back(light.Ambient);
+	diffuse.push_back(light.Diffuse);
+	specular.push_back(light.Specular);
+	position.push_back(lightPosition);
+	direction.push_back(lightDirection);
+	attenuation.push_back(lightAttenuation);
+	cutOff.push_back(lightCutOff);
+	range.push_back(0.0f);
+	slot.push_back(lightSlot);
+	spot.push_back(isSpot ? 1 : 0);
+	dirty.push_back(0);
+	texels.resize(Count() * TEXELS_PER_LIGHT);
+	if (lightSlot != NO_SLOT)
+		slotLight[lightSlot] = (int)id;
+
+	updateRange(id);
+	markDirty(id);
+	return id;
+}
+
+void LightManager::markDirty(unsigned int light)
+{
+	dirty[light] = 1;
+	if (firstDirty == lastDirty) {
+		firstDirty = light;
+		lastDirty = light + 1;
+	}
+	else {
+		firstDirty = std::min(firstDirty, light);
+		lastDirty = std::max(lastDirty, light + 1);
+	}
+}
+
+void LightManager::updateRange(unsigned int light)
+{
+	float peak = Light::Peak(color[light], ambient[light], diffuse[light], specular[light]);
+	range[light] = PointLight::AttenuationRange(peak, attenuation[light].x, attenuation[light].y, attenuation[light].z);
+}
+
+bool LightManager::touches(int light, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax) const
+{
+	if (light == NO_SLOT)
+		return false;
+	// distance from the light to the closest point of the box
+	glm::vec3 d = glm::max(boundsMin - position[light], glm::vec3(0.0f)) + glm::max(position[light] - boundsMax, glm::vec3(0.0f));
+	return glm::dot(d, d) <= range[light] * range[light];
+}
+
+void LightManager::packSlot(unsigned int lightSlot, unsigned int light)
+{
+	bool spotSlot = lightSlot >= 1 + MAX_POINT_LIGHTS;
+	PointLightStd140 &out = spotSlot ? block.spotLights[lightSlot - 1 - MAX_POINT_LIGHTS].base : block.pointLights[lightSlot - 1];
+	out.base.color = color[light];
+	out.base.ambient = ambient[light];
+	out.base.diffuse = diffuse[light];
+	out.base.specular = specular[light];
+	out.position = position[light];
+	out.constant = attenuation[light].x;
+	out.linear = attenuation[light].y;
+	out.quadratic = attenuation[light].z;
+	if (spotSlot) {
+		SpotLightStd140 &spotOut = block.spotLights[lightSlot - 1 - MAX_POINT_LIGHTS];
+		spotOut.direction = direction[light];
+		spotOut.cutOff = cutOff[light].x;
+		spotOut.outerCutOff = cutOff[light].y;
+	}
+}
+
+void LightManager::packTexels(unsigned int light)
+{
+	glm::vec4* out = &texels[light * TEXELS_PER_LIGHT];
+	out[0] = glm::vec4(position[light], attenuation[light].x);
+	out[1] = glm::vec4(ambient[light] * color[light], attenuation[light].y);
+	out[2] = glm::vec4(diffuse[light] * color[light], attenuation[light].z);
+	out[3] = glm::vec4(specular[light] * color[light], cutOff[light].x);
+	out[4] = glm::vec4(direction[light], cutOff[light].y);
+}
+
+void LightManager::uploadSlots()
+{
+	if (dirtySlots == 0)
+		return;
+	if (dirtySlots & (1u << DIR_SLOT))
+		block.dirLight = dirLight;
+
+	// slots are laid out in block order, so a run of dirty slots is one contiguous range
+	unsigned int first = 0;
+	while (first < SLOT_COUNT) {
+		if (!(dirtySlots & (1u << first))) {
+			first++;
+			continue;
+		}
+
+		unsigned int end = first;
+		while (end < SLOT_COUNT && (dirtySlots & (1u << end)))
+			end++;
+
+		unsigned int offset, size, lastOffset, lastSize;
+		slotRange(first, offset, size);
+		slotRange(end - 1, lastOffset, lastSize);
+		size = lastOffset + lastSize - offset;
+
+		buffer.Update(block, offset, size);
+		uploadedBytes += size;
+		first = end;
+	}
+	dirtySlots = 0;
+}
+
+void LightManager::uploadTexels()
+{
+	// initialize if necessary
+	if (lightTexture == 0) {
+		glGenBuffers(1, &lightBuffer);
+		glGenTextures(1, &lightTexture);
+	}
+
+	glBindBuffer(GL_TEXTURE_BUFFER, lightBuffer);
+	if (Count() > lightCapacity) {
+		// grow the buffer and send every light, the texture has to be attached to the new storage
+		lightCapacity = std::max(Count(), lightCapacity * 2);
+		glBufferData(GL_TEXTURE_BUFFER, lightCapacity * TEXELS_PER_LIGHT * sizeof(glm::vec4), nullptr, GL_DYNAMIC_DRAW);
+		glBufferSubData(GL_TEXTURE_BUFFER, 0, texels.size() * sizeof(glm::vec4), texels.data());
+		uploadedBytes += (unsigned int)(texels.size() * sizeof(glm::vec4));
+		glBindTexture(GL_TEXTURE_BUFFER, lightTexture);
+		glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, lightBuffer);
+		glBindTexture(GL_TEXTURE_BUFFER, 0);
+	}
+	else if (firstDirty < lastDirty) {
+		// one range from the first to the last dirty light, the clean ones in between are current
+		unsigned int offset = firstDirty * TEXELS_PER_LIGHT * sizeof(glm::vec4);
+		unsigned int size = (lastDirty - firstDirty) * TEXELS_PER_LIGHT * sizeof(glm::vec4);
+		glBufferSubData(GL_TEXTURE_BUFFER, offset, size, &texels[firstDirty * TEXELS_PER_LIGHT]);
+		uploadedBytes += size;
+	}
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightManager::slotRange(unsigned int lightSlot, unsigned int &offset, unsigned int &size) const
+{
+	if (lightSlot == DIR_SLOT) {
+		offset = offsetof(LightBlockStd140, dirLight);
+		size = sizeof(DirLightStd140);
+	}
+	else if (lightSlot < 1 + MAX_POINT_LIGHTS) {
+		offset = offsetof(LightBlockStd140, pointLights) + (lightSlot - 1) * sizeof(PointLightStd140);
+		size = sizeof(PointLightStd140);
+	}
+	else {
+		offset = offsetof(LightBlockStd140, spotLights) + (lightSlot - 1 - MAX_POINT_LIGHTS) * sizeof(SpotLightStd140);
+		size = sizeof(SpotLightStd140);
+	}
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "DirectionalLight.h"
+#include "PointLight.h"
+#include "SpotLight.h"
+#include "LightBuffer.h"
+
+// lights of the Lights block one draw is shaded with, as indices into its pointLights and spotLights
+struct DrawLights {
+	unsigned int pointCount;
+	unsigned int spotCount;
+	int pointLights[LightBlockStd140::MAX_POINT_LIGHTS];
+	int spotLights[LightBlockStd140::MAX_SPOT_LIGHTS];
+};
+
+// Owns the lights of the scene. Every attribute of the point and spot lights is stored in its own
+// array indexed by the light's id, so passes that only need positions and ranges walk contiguous
+// memory. The setters mark a light dirty only when a value really changes, and Upload() sends
+// just the dirty lights:
+//  - the first MAX_POINT_LIGHTS point lights and MAX_SPOT_LIGHTS spot lights go into their slots
+//    of the Lights uniform block, adjacent dirty slots merged into one glBufferSubData
+//  - every light goes into a texture buffer of TEXELS_PER_LIGHT RGBA32F texels, read by the
+//    clustered shading path (see ClusteredLights)
+// Draws through the Lights block are culled per object and per mesh with CullBlockLights(),
+// against each light's range.
+class LightManager {
+public:
+	static const unsigned int MAX_POINT_LIGHTS = LightBlockStd140::MAX_POINT_LIGHTS;
+	static const unsigned int MAX_SPOT_LIGHTS = LightBlockStd140::MAX_SPOT_LIGHTS;
+	// position and constant, ambient and linear, diffuse and quadratic, specular and cutOff,
+	// direction and outerCutOff, the colors premultiplied by the light color
+	static const unsigned int TEXELS_PER_LIGHT = 5;
+
+	LightManager();
+
+	void SetDirectionalLight(const DirectionalLight &light);
+	// id of the new light, ids are handed out in order starting at 0
+	unsigned int AddPointLight(const PointLight &light);
+	unsigned int AddSpotLight(const SpotLight &light);
+	// removes every light from id count on
+	void Truncate(unsigned int count);
+
+	void SetPosition(unsigned int light, const glm::vec3 &position);
+	void SetColor(unsigned int light, const glm::vec3 &color);
+	void SetDirection(unsigned int light, const glm::vec3 &direction);
+
+	unsigned int Count() const { return (unsigned int)position.size(); }
+	// contiguous arrays of Count() entries
+	const glm::vec3* Positions() const { return position.data(); }
+	// distance at which the light falls below 1/256 of its peak, the bound used for culling
+	const float* Ranges() const { return range.data(); }
+
+	// id of the light in a pointLights slot of the Lights block, -1 if the slot is empty
+	int BlockPointLight(unsigned int index) const { return slotLight[1 + index]; }
+	// every light of the Lights block
+	void BlockLights(DrawLights &out) const;
+	// the lights of candidates whose range reaches the world-space box, out may be candidates
+	void CullBlockLights(const DrawLights &candidates, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax, DrawLights &out) const;
+
+	// uploads the lights changed since the last call
+	void Upload();
+	// texture buffer with every light, valid after the first Upload()
+	unsigned int LightTexture() const { return lightTexture; }
+	// lights and bytes sent by the last Upload()
+	unsigned int LastUploadedLights() const { return uploadedLights; }
+	unsigned int LastUploadedBytes() const { return uploadedBytes; }
+
+private:
+	static const unsigned int DIR_SLOT = 0;
+	static const unsigned int SLOT_COUNT = 1 + MAX_POINT_LIGHTS + MAX_SPOT_LIGHTS;
+	static const int NO_SLOT = -1;
+
+	unsigned int pointCount;
+	unsigned int spotCount;
+
+	// the directional light only lives in the uniform block
+	DirLightStd140 dirLight;
+
+	// one entry per light
+	std::vector<glm::vec3> color;
+	std::vector<glm::vec3> ambient;
+	std::vector<glm::vec3> diffuse;
+	std::vector<glm::vec3> specular;
+	std::vector<glm::vec3> position;
+	std::vector<glm::vec3> direction;
+	// constant, linear and quadratic terms
+	std::vector<glm::vec3> attenuation;
+	// cosines of the inner and outer cone, point lights use a cone that includes everything
+	std::vector<glm::vec2> cutOff;
+	std::vector<float> range;
+	// slot in the Lights block or NO_SLOT
+	std::vector<int> slot;
+	std::vector<unsigned char> spot;
+	std::vector<unsigned char> dirty;
+	// light in every slot of the Lights block or NO_SLOT
+	int slotLight[SLOT_COUNT];
+
+	// bit per slot of the Lights block
+	unsigned int dirtySlots;
+	// dirty lights all lie in [firstDirty, lastDirty)
+	unsigned int firstDirty;
+	unsigned int lastDirty;
+	unsigned int uploadedLights;
+	unsigned int uploadedBytes;
+
+	// CPU copies of the GPU data the dirty lights are packed into before uploading
+	LightBlockStd140 block;
+	std::vector<glm::vec4> texels;
+	LightBuffer buffer;
+	unsigned int lightBuffer;
+	unsigned int lightTexture;
+	// lights the texture buffer has room for
+	unsigned int lightCapacity;
+
+	unsigned int addLight(const Light &light, const glm::vec3 &lightPosition, const glm::vec3 &lightDirection, const glm::vec3 &lightAttenuation, const glm::vec2 &lightCutOff, int lightSlot, bool isSpot);
+	void markDirty(unsigned int light);
+	void updateRange(unsigned int light);
+	bool touches(int light, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax) const;
+	void packSlot(unsigned int slot, unsigned int light);
+	void packTexels(unsigned int light);
+	void uploadSlots();
+	void uploadTexels();
+	void slotRange(unsigned int slot, unsigned int &offset, unsigned int &size) const;
+};
@@ -1,10 +1,23 @@
 #include "Mesh.h"
 
-Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures)
+#include <glm/gtc/packing.hpp>
+
+#include <cmath>
+
+#include "Profiler.h"
+
+Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures, VertexLayout layout)
 {
 	this->vertices = vertices;
 	this->indices = indices;
 	this->textures = textures;
+	Layout = layout;
+
+	BoundsMin = BoundsMax = vertices.empty() ? glm::vec3(0.0f) : vertices[0].Position;
+	for (size_t i = 1; i < vertices.size(); i++) {
+		BoundsMin = glm::min(BoundsMin, vertices[i].Position);
+		BoundsMax = glm::max(BoundsMax, vertices[i].Position);
+	}
 
 	// we have all the required data, set the vertex buffers and its attribute pointers
 	setupMesh();
@@ -34,11 +47,21 @@ void Mesh::Draw(Shader & shader)
 			number = std::to_string(heightNr++);
 
 		// set the sampler to the correct texture unit
-		glUniform1i(glGetUniformLocation(shader.ID, (name + number).c_str()), i);
+		shader.setInt(name + number, (int)i);
 		// bind the texture
 		glBindTexture(GL_TEXTURE_2D, textures[i].id);
 	}
 
+	// packed positions are stored between the bounds, full ones as they are
+	if (Layout == PackedVertexLayout) {
+		shader.setVec3("positionOffset", BoundsMin.x, BoundsMin.y, BoundsMin.z);
+		shader.setVec3("positionScale", BoundsMax.x - BoundsMin.x, BoundsMax.y - BoundsMin.y, BoundsMax.z - BoundsMin.z);
+	} else {
+		shader.setVec3("positionOffset", 0.0f, 0.0f, 0.0f);
+		shader.setVec3("positionScale", 1.0f, 1.0f, 1.0f);
+	}
+	shader.setBool("packedNormals", Layout == PackedVertexLayout);
+
 	// draw mesh
 	glBindVertexArray(VAO);
 	glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
@@ -48,35 +71,79 @@ void Mesh::Draw(Shader & shader)
 	glActiveTexture(GL_TEXTURE0);
 }
 
+void Mesh::DrawDepth() const
+{
+	glBindVertexArray(DepthVAO);
+	glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+	glBindVertexArray(0);
+}
+
+void Mesh::packVertices(std::vector<PackedVertex> &packed) const
+{
+	glm::vec3 extent = BoundsMax - BoundsMin;
+	// a flat axis keeps every position at the bound
+	glm::vec3 scale(extent.x > 0.0f ? 1.0f / extent.x : 0.0f, extent.y > 0.0f ? 1.0f / extent.y : 0.0f, extent.z > 0.0f ? 1.0f / extent.z : 0.0f);
+
+	packed.resize(vertices.size());
+	for (size_t i = 0; i < vertices.size(); i++) {
+		const Vertex &vertex = vertices[i];
+		PackedVertex &out = packed[i];
+
+		glm::vec3 position = glm::clamp((vertex.Position - BoundsMin) * scale, 0.0f, 1.0f);
+		for (int axis = 0; axis < 3; axis++)
+			out.position[axis] = (uint16_t)std::lround(position[axis] * 65535.0f);
+		// handedness of the tangent frame, the bitangent is rebuilt from the normal and the tangent
+		bool flipped = glm::dot(glm::cross(vertex.Normal, vertex.Tangent), vertex.Bitangent) < 0.0f;
+		out.position[3] = flipped ? 0 : 65535;
+
+		glm::vec2 normal = OctahedronEncode(vertex.Normal);
+		out.normal[0] = PackSnorm16(normal.x);
+		out.normal[1] = PackSnorm16(normal.y);
+		out.texCoords[0] = (uint16_t)glm::packHalf1x16(vertex.TexCoords.x);
+		out.texCoords[1] = (uint16_t)glm::packHalf1x16(vertex.TexCoords.y);
+		glm::vec2 tangent = OctahedronEncode(vertex.Tangent);
+		out.tangent[0] = PackSnorm16(tangent.x);
+		out.tangent[1] = PackSnorm16(tangent.y);
+	}
+}
+
 void Mesh::setupMesh()
 {
+	PROFILE_FUNCTION();
+
 	glGenVertexArrays(1, &VAO);
 	glGenBuffers(1, &VBO);
 	glGenBuffers(1, &EBO);
 
 	glBindVertexArray(VAO);
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+	if (Layout == PackedVertexLayout) {
+		std::vector<PackedVertex> packed;
+		packVertices(packed);
+		glBufferData(GL_ARRAY_BUFFER, packed.size() * sizeof(PackedVertex), packed.data(), GL_STATIC_DRAW);
+	} else
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
 
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
 
 	// set the vertex attribute pointers
-	// vertex positions
+	VertexFormat::Get(Layout).Apply();
+
+	// the depth passes fetch 12 bytes per vertex instead of the whole Vertex, same indices
+	std::vector<glm::vec3> positions(vertices.size());
+	for (size_t i = 0; i < vertices.size(); i++)
+		positions[i] = vertices[i].Position;
+
+	glGenVertexArrays(1, &DepthVAO);
+	glGenBuffers(1, &PositionVBO);
+
+	glBindVertexArray(DepthVAO);
+	glBindBuffer(GL_ARRAY_BUFFER, PositionVBO);
+	glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec3), positions.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
 	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), nullptr);
-	// vertex normals
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
-	// vertex Texture coords
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
-	// vertex tangent
-	glEnableVertexAttribArray(3);
-	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Tangent));
-	// vertex bitangent
-	glEnableVertexAttribArray(4);
-	glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Bitangent));
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr);
 
 	glBindVertexArray(0);
 }
\ No newline at end of file
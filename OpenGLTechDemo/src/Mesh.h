@@ -7,6 +7,7 @@
 #include "glm/gtc/matrix_transform.hpp"
 
 #include "Shader.h"
+#include "VertexFormat.h"
 
 struct Vertex {
 	glm::vec3 Position;
@@ -29,15 +30,23 @@ public:
 	std::vector<unsigned int> indices;
 	std::vector<Texture> textures;
 	unsigned int VAO;
-
-	Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures);
+	// positions only (location 0), tightly packed, for the depth passes
+	unsigned int DepthVAO;
+	// model-space box around the vertices
+	glm::vec3 BoundsMin, BoundsMax;
+	// layout of the VAO's vertex buffer, the depth stream is always float positions
+	VertexLayout Layout;
+
+	Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures, VertexLayout layout = PackedVertexLayout);
 	void Draw(Shader &shader);
-
+	// draws through DepthVAO without binding textures, for shaders that only read aPos
+	void DrawDepth() const;
 
 private:
-	unsigned int VBO, EBO;
+	unsigned int VBO, EBO, PositionVBO;
 
 	void setupMesh();
+	void packVertices(std::vector<PackedVertex> &packed) const;
 
 
 };
\ No newline at end of file
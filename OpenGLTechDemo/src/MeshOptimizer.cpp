@@ -0,0 +1,257 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+
+#include "Profiler.h"
+
+namespace {
+	// a vertex is in the FIFO cache while fewer than VERTEX_CACHE_SIZE misses happened since its own,
+	// advancing time by more than that empties the cache
+	bool cacheMiss(std::vector<unsigned int> &cached, unsigned int &time, unsigned int vertex)
+	{
+		if (time - cached[vertex] <= VERTEX_CACHE_SIZE)
+			return false;
+		cached[vertex] = time++;
+		return true;
+	}
+
+	unsigned int triangleMisses(const std::vector<unsigned int> &indices, unsigned int triangle, std::vector<unsigned int> &cached, unsigned int &time)
+	{
+		unsigned int misses = 0;
+		for (unsigned int corner = 0; corner < 3; corner++)
+			misses += cacheMiss(cached, time, indices[triangle * 3 + corner]) ? 1 : 0;
+		return misses;
+	}
+
+	struct Cluster {
+		unsigned int begin, end;
+		// how far the cluster faces away from the mesh's center
+		float outwardness;
+	};
+}
+
+void VertexCacheStats::Add(const VertexCacheStats &stats)
+{
+	triangles += stats.triangles;
+	vertices += stats.vertices;
+	transforms += stats.transforms;
+}
+
+VertexCacheStats AnalyzeVertexCache(const std::vector<unsigned int> &indices, unsigned int vertexCount)
+{
+	VertexCacheStats stats;
+	stats.triangles = (unsigned int)(indices.size() / 3);
+
+	std::vector<unsigned int> cached(vertexCount, 0);
+	std::vector<bool> used(vertexCount, false);
+	unsigned int time = VERTEX_CACHE_SIZE + 1;
+	for (size_t i = 0; i < indices.size(); i++) {
+		if (cacheMiss(cached, time, indices[i]))
+			stats.transforms++;
+		if (!used[indices[i]]) {
+			used[indices[i]] = true;
+			stats.vertices++;
+		}
+	}
+	return stats;
+}
+
+void OptimizeVertexCache(std::vector<unsigned int> &indices, unsigned int vertexCount, std::vector<unsigned int> &clusters)
+{
+	PROFILE_FUNCTION();
+
+	clusters.clear();
+	unsigned int triangleCount = (unsigned int)(indices.size() / 3);
+	if (triangleCount == 0)
+		return;
+
+	// triangles around every vertex, live counts the ones not emitted yet
+	std::vector<unsigned int> live(vertexCount, 0);
+	for (size_t i = 0; i < indices.size(); i++)
+		live[indices[i]]++;
+	std::vector<unsigned int> offsets(vertexCount + 1, 0);
+	for (unsigned int v = 0; v < vertexCount; v++)
+		offsets[v + 1] = offsets[v] + live[v];
+	std::vector<unsigned int> adjacency(indices.size());
+	std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+	for (size_t i = 0; i < indices.size(); i++)
+		adjacency[fill[indices[i]]++] = (unsigned int)(i / 3);
+
+	std::vector<unsigned int> cached(vertexCount, 0);
+	unsigned int time = VERTEX_CACHE_SIZE + 1;
+	std::vector<bool> emitted(triangleCount, false);
+	// vertices of the emitted triangles, newest last, to continue from once a fan runs dry
+	std::vector<unsigned int> deadEnds;
+	std::vector<unsigned int> candidates;
+	std::vector<unsigned int> result;
+	result.reserve(indices.size());
+	unsigned int cursor = 0;
+
+	int fan = -1;
+	for (;;) {
+		if (fan < 0) {
+			// dead end, the most recently used vertex with triangles left or else the next one in
+			// input order, either way the cache is cold from here
+			while (fan < 0 && !deadEnds.empty()) {
+				unsigned int v = deadEnds.back();
+				deadEnds.pop_back();
+				if (live[v] > 0)
+					fan = (int)v;
+			}
+			while (fan < 0 && cursor < vertexCount) {
+				if (live[cursor] > 0)
+					fan = (int)cursor;
+				cursor++;
+			}
+			if (fan < 0)
+				break;
+			clusters.push_back((unsigned int)(result.size() / 3));
+		}
+
+		// emit every triangle left around the fan vertex
+		candidates.clear();
+		for (unsigned int k = offsets[fan]; k < offsets[fan + 1]; k++) {
+			unsigned int triangle = adjacency[k];
+			if (emitted[triangle])
+				continue;
+			emitted[triangle] = true;
+			for (unsigned int corner = 0; corner < 3; corner++) {
+				unsigned int v = indices[triangle * 3 + corner];
+				result.push_back(v);
+				deadEnds.push_back(v);
+				candidates.push_back(v);
+				live[v]--;
+				cacheMiss(cached, time, v);
+			}
+		}
+
+		// next fan: the oldest candidate that is still cached after emitting its triangles
+		fan = -1;
+		int bestPriority = -1;
+		for (size_t i = 0; i < candidates.size(); i++) {
+			unsigned int v = candidates[i];
+			if (live[v] == 0)
+				continue;
+			int priority = 0;
+			if (time - cached[v] + 2 * live[v] <= VERTEX_CACHE_SIZE)
+				priority = (int)(time - cached[v]);
+			if (priority > bestPriority) {
+				bestPriority = priority;
+				fan = (int)v;
+			}
+		}
+	}
+
+	indices.swap(result);
+}
+
+void OptimizeOverdraw(std::vector<unsigned int> &indices, const std::vector<Vertex> &vertices, const std::vector<unsigned int> &clusters, float threshold)
+{
+	PROFILE_FUNCTION();
+
+	unsigned int triangleCount = (unsigned int)(indices.size() / 3);
+	if (triangleCount == 0 || clusters.empty())
+		return;
+
+	// cut the cache runs where their ACMR so far is close to the whole run's, each piece starts cold
+	std::vector<Cluster> pieces;
+	std::vector<unsigned int> cached(vertices.size(), 0);
+	unsigned int time = VERTEX_CACHE_SIZE + 1;
+	for (size_t c = 0; c < clusters.size(); c++) {
+		unsigned int begin = clusters[c];
+		unsigned int end = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+
+		time += VERTEX_CACHE_SIZE + 1;
+		unsigned int misses = 0;
+		for (unsigned int t = begin; t < end; t++)
+			misses += triangleMisses(indices, t, cached, time);
+		float limit = (float)misses / (end - begin) * threshold;
+
+		time += VERTEX_CACHE_SIZE + 1;
+		Cluster piece = { begin, end, 0.0f };
+		misses = 0;
+		for (unsigned int t = begin; t < end; t++) {
+			misses += triangleMisses(indices, t, cached, time);
+			if (t + 1 < end && (float)misses / (t + 1 - piece.begin) <= limit) {
+				piece.end = t + 1;
+				pieces.push_back(piece);
+				piece.begin = t + 1;
+				misses = 0;
+				time += VERTEX_CACHE_SIZE + 1;
+			}
+		}
+		piece.end = end;
+		pieces.push_back(piece);
+	}
+
+	// area weighted centroid and normal of every piece and the centroid of the mesh
+	std::vector<glm::vec3> centroids(pieces.size()), normals(pieces.size());
+	glm::vec3 meshCentroid(0.0f);
+	float meshArea = 0.0f;
+	for (size_t p = 0; p < pieces.size(); p++) {
+		glm::vec3 centroid(0.0f), normal(0.0f);
+		float area = 0.0f;
+		for (unsigned int t = pieces[p].begin; t < pieces[p].end; t++) {
+			const glm::vec3 &a = vertices[indices[t * 3]].Position;
+			const glm::vec3 &b = vertices[indices[t * 3 + 1]].Position;
+			const glm::vec3 &c = vertices[indices[t * 3 + 2]].Position;
+			glm::vec3 cross = glm::cross(b - a, c - a);
+			float triangleArea = glm::length(cross);
+			centroid += (a + b + c) * (triangleArea / 3.0f);
+			normal += cross;
+			area += triangleArea;
+		}
+		meshCentroid += centroid;
+		meshArea += area;
+		centroids[p] = area > 0.0f ? centroid / area : centroid;
+		normals[p] = normal;
+	}
+	if (meshArea > 0.0f)
+		meshCentroid /= meshArea;
+
+	for (size_t p = 0; p < pieces.size(); p++) {
+		float length = glm::length(normals[p]);
+		pieces[p].outwardness = length > 0.0f ? glm::dot(centroids[p] - meshCentroid, normals[p] / length) : 0.0f;
+	}
+	std::stable_sort(pieces.begin(), pieces.end(), [](const Cluster &a, const Cluster &b) { return a.outwardness > b.outwardness; });
+
+	std::vector<unsigned int> result;
+	result.reserve(indices.size());
+	for (size_t p = 0; p < pieces.size(); p++)
+		result.insert(result.end(), indices.begin() + pieces[p].begin * 3, indices.begin() + pieces[p].end * 3);
+	indices.swap(result);
+}
+
+void OptimizeVertexFetch(std::vector<Vertex> &vertices, std::vector<unsigned int> &indices)
+{
+	PROFILE_FUNCTION();
+
+	// vertices no index refers to are dropped
+	const unsigned int unused = ~0u;
+	std::vector<unsigned int> remap(vertices.size(), unused);
+	std::vector<Vertex> ordered;
+	ordered.reserve(vertices.size());
+	for (size_t i = 0; i < indices.size(); i++) {
+		unsigned int v = indices[i];
+		if (remap[v] == unused) {
+			remap[v] = (unsigned int)ordered.size();
+			ordered.push_back(vertices[v]);
+		}
+		indices[i] = remap[v];
+	}
+	vertices.swap(ordered);
+}
+
+void OptimizeMesh(std::vector<Vertex> &vertices, std::vector<unsigned int> &indices, VertexCacheStats &before, VertexCacheStats &after)
+{
+	PROFILE_FUNCTION();
+
+	before = AnalyzeVertexCache(indices, (unsigned int)vertices.size());
+
+	std::vector<unsigned int> clusters;
+	OptimizeVertexCache(indices, (unsigned int)vertices.size(), clusters);
+	OptimizeOverdraw(indices, vertices, clusters, 1.05f);
+	OptimizeVertexFetch(vertices, indices);
+
+	after = AnalyzeVertexCache(indices, (unsigned int)vertices.size());
+}
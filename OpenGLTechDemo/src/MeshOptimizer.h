@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+
+#include "Mesh.h"
+
+// Reorders the triangles and vertices of a mesh once at load, so the GPU transforms and fetches
+// fewer vertices per triangle:
+//   OptimizeVertexCache	Tipsify (Sander, Nehab and Barczak 2007), fans the triangles around the
+//						vertices most recently put in the cache and marks where the order had to
+//						jump to an unrelated part of the mesh
+//   OptimizeOverdraw	cuts those runs further wherever the cache was warm anyway and sorts the
+//						pieces so the ones facing away from the mesh's center are drawn first, they
+//						tend to hide the rest and cut overdraw of the early depth test
+//   OptimizeVertexFetch	renumbers the vertices in the order the indices first use them, so the
+//						fetches walk the vertex buffer forwards
+// Each stage keeps the triangles and their winding, only the order changes.
+
+// entries of the FIFO post-transform cache that is simulated and optimized for
+const unsigned int VERTEX_CACHE_SIZE = 16;
+
+// cost of an index buffer in the simulated post-transform cache
+struct VertexCacheStats {
+	unsigned int triangles;
+	unsigned int vertices;
+	// cache misses, each one a vertex shader invocation
+	unsigned int transforms;
+
+	VertexCacheStats() : triangles(0), vertices(0), transforms(0) {}
+	void Add(const VertexCacheStats &stats);
+	// average cache miss ratio, transforms per triangle: 3 at worst, about 0.5 for a large grid
+	float ACMR() const { return triangles ? (float)transforms / triangles : 0.0f; }
+	// average transform to vertex ratio, 1 when every vertex is transformed once
+	float ATVR() const { return vertices ? (float)transforms / vertices : 0.0f; }
+};
+
+VertexCacheStats AnalyzeVertexCache(const std::vector<unsigned int> &indices, unsigned int vertexCount);
+
+// clusters receives the first triangle of every run that starts with a cold cache
+void OptimizeVertexCache(std::vector<unsigned int> &indices, unsigned int vertexCount, std::vector<unsigned int> &clusters);
+// a run is cut where its ACMR so far is within threshold times the ACMR of the whole run, 1.05
+// keeps the cache ordering almost as good
+void OptimizeOverdraw(std::vector<unsigned int> &indices, const std::vector<Vertex> &vertices, const std::vector<unsigned int> &clusters, float threshold);
+void OptimizeVertexFetch(std::vector<Vertex> &vertices, std::vector<unsigned int> &indices);
+
+// all three stages, returns the cost of the indices before and after
+void OptimizeMesh(std::vector<Vertex> &vertices, std::vector<unsigned int> &indices, VertexCacheStats &before, VertexCacheStats &after);
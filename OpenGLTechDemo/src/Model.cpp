@@ -1,8 +1,10 @@
 #include "Model.h"
 
+#include "MeshOptimizer.h"
 #include "stb_image.h"
+#include "Profiler.h"
 
-Model::Model(std::string const & path, bool gamma) : gammaCorrection(gamma)
+Model::Model(std::string const & path, bool gamma, VertexLayout layout, bool optimize) : gammaCorrection(gamma), BoundsMin(0.0f), BoundsMax(0.0f), Layout(layout), optimize(optimize)
 {
 	loadModel(path);
 }
@@ -14,8 +16,14 @@ void Model::Draw(Shader & shader)
 }
 void Model::loadModel(std::string const & path)
 {
+	PROFILE_FUNCTION();
+
 	Assimp::Importer importer;
-	const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+	const aiScene* scene;
+	{
+		PROFILE_ZONE("Assimp::ReadFile");
+		scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+	}
 	if (!scene) {		
 		std::cout << "Error::Assimp: " << importer.GetErrorString() << std::endl;
 		return;
@@ -24,6 +32,11 @@ void Model::loadModel(std::string const & path)
 	directory = path.substr(0, path.find_last_of('/'));
 
 	processNode(scene->mRootNode, scene);
+
+	for (size_t i = 0; i < meshes.size(); i++) {
+		BoundsMin = i == 0 ? meshes[i].BoundsMin : glm::min(BoundsMin, meshes[i].BoundsMin);
+		BoundsMax = i == 0 ? meshes[i].BoundsMax : glm::max(BoundsMax, meshes[i].BoundsMax);
+	}
 }
 
 
@@ -41,6 +54,8 @@ void Model::processNode(aiNode * node, const aiScene * scene)
 
 Mesh Model::processMesh(aiMesh * mesh, const aiScene * scene)
 {
+	PROFILE_FUNCTION();
+
 	std::vector<Vertex> vertices;
 	std::vector<unsigned int> indices;
 	std::vector<Texture> textures;
@@ -78,6 +93,8 @@ Mesh Model::processMesh(aiMesh * mesh, const aiScene * scene)
 			vertex.Bitangent = vector;
 		} else {
 			vertex.TexCoords = glm::vec2(0.0f, 0.0f);
+			vertex.Tangent = glm::vec3(0.0f);
+			vertex.Bitangent = glm::vec3(0.0f);
 		}
 		vertices.push_back(vertex);
 	}
@@ -88,6 +105,15 @@ Mesh Model::processMesh(aiMesh * mesh, const aiScene * scene)
 			indices.push_back(face.mIndices[j]);
 	}
 
+	// reorder for the post-transform cache, overdraw and vertex fetch, only triangle lists qualify
+	VertexCacheStats before, after;
+	if (optimize && indices.size() % 3 == 0)
+		OptimizeMesh(vertices, indices, before, after);
+	else
+		before = after = AnalyzeVertexCache(indices, (unsigned int)vertices.size());
+	CacheBefore.Add(before);
+	CacheAfter.Add(after);
+
 	aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
 
 	// 1. diffuse maps
@@ -104,11 +130,13 @@ Mesh Model::processMesh(aiMesh * mesh, const aiScene * scene)
 	textures.insert(textures.end(), heightMaps.begin(), heightMaps.end());
 
 	// return a mesh object created from the extracted mesh data
-	return Mesh(vertices, indices, textures);
+	return Mesh(vertices, indices, textures, Layout);
 }
 
 std::vector<Texture> Model::loadMaterialTextures(aiMaterial * mat, aiTextureType type, std::string typeName)
 {
+	PROFILE_FUNCTION();
+
 	std::vector<Texture> textures;
 	for (unsigned int i = 0; i < mat->GetTextureCount(type); i++) {
 		aiString str;
@@ -136,6 +164,8 @@ std::vector<Texture> Model::loadMaterialTextures(aiMaterial * mat, aiTextureType
 
 unsigned int TextureFromFile(const char * path, const std::string & directory, bool gamma)
 {
+	PROFILE_FUNCTION();
+
 	std::string fileName = std::string(path);
 	fileName = directory + '/' + fileName;
 
@@ -18,6 +18,7 @@
 
 #include "Shader.h"
 #include "Mesh.h"
+#include "MeshOptimizer.h"
 
 unsigned int TextureFromFile(const char* path, const std::string &directory, bool gamma = false);
 
@@ -27,13 +28,22 @@ public:
 	std::vector<Mesh> meshes;
 	std::string directory;
 	bool gammaCorrection;
+	// model-space box around every mesh
+	glm::vec3 BoundsMin, BoundsMax;
+	// vertex buffer layout of every mesh
+	VertexLayout Layout;
+	// post-transform cache cost of every mesh's indices as loaded and as drawn
+	VertexCacheStats CacheBefore, CacheAfter;
 
-	Model() = default;
-	Model(std::string const &path, bool gamma = false);
+	Model() : gammaCorrection(false), BoundsMin(0.0f), BoundsMax(0.0f), Layout(PackedVertexLayout), optimize(false) {}
+	// optimize reorders the triangles and vertices of every mesh (see MeshOptimizer.h)
+	Model(std::string const &path, bool gamma = false, VertexLayout layout = PackedVertexLayout, bool optimize = true);
 
 	void Draw(Shader &shader);
 
 private:
+	bool optimize;
+
 	void loadModel(std::string const &path);
 	void processNode(aiNode* node, const aiScene* scene);
 	Mesh processMesh(aiMesh* mesh, const aiScene* scene);
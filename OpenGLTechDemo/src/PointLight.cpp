@@ -1,8 +1,17 @@
-#include <string>
 #include "PointLight.h"
 
+#include <algorithm>
+#include <cmath>
 
-PointLight::PointLight(Shader &shader) : Light(shader)
+namespace {
+	// a light's contribution is cut off below this fraction of its peak
+	const float RANGE_THRESHOLD = 1.0f / 256.0f;
+	// used when the attenuation never reaches the threshold
+	const float MAX_RANGE = 1000.0f;
+}
+
+
+PointLight::PointLight() : Light()
 {
 	Position = glm::vec3(0.0f, 0.0f, 0.0f);
 	Constant = 1.0f;
@@ -10,11 +19,11 @@ PointLight::PointLight(Shader &shader) : Light(shader)
 	Quadratic = 0.0f;
 }
 
-PointLight::PointLight(Shader &shader, 
+PointLight::PointLight(
 	glm::vec3 color,
 	glm::vec3 ambient, glm::vec3 diffuse, glm::vec3 specular,
 	glm::vec3 position,
-	float constant, float linear, float quadratic) : Light(shader, color, ambient, diffuse, specular)
+	float constant, float linear, float quadratic) : Light(color, ambient, diffuse, specular)
 {
 	Position = position;
 	Constant = constant;
@@ -22,14 +31,26 @@ PointLight::PointLight(Shader &shader,
 	Quadratic = quadratic;
 }
 
-void PointLight::UseLight(unsigned int id)
-{	
-	shader.setVec3("pointLights[" + std::to_string(id) + ']' + ".base.color", Color);
-	shader.setVec3("pointLights[" + std::to_string(id) + ']' + ".base.ambient", Ambient);
-	shader.setVec3("pointLights[" + std::to_string(id) + ']' + ".base.diffuse", Diffuse);
-	shader.setVec3("pointLights[" + std::to_string(id) + ']' + ".base.specular", Specular);
-	shader.setVec3("pointLights[" + std::to_string(id) + ']' + ".position", Position);
-	shader.setFloat("pointLights[" + std::to_string(id) + ']' + ".constant", Constant);
-	shader.setFloat("pointLights[" + std::to_string(id) + ']' + ".linear", Linear);
-	shader.setFloat("pointLights[" + std::to_string(id) + ']' + ".quadratic", Quadratic);
+void PointLight::SetPosition(glm::vec3 position)
+{
+	Position = position;
+}
+
+float PointLight::Range() const
+{
+	return AttenuationRange(Peak(), Constant, Linear, Quadratic);
+}
+
+float PointLight::AttenuationRange(float peak, float constant, float linear, float quadratic)
+{
+	// solve constant + linear * d + quadratic * d^2 = peak / threshold for d
+	float c = constant - peak / RANGE_THRESHOLD;
+	float d = MAX_RANGE;
+	if (c >= 0.0f)
+		d = 0.0f;
+	else if (quadratic > 0.0f)
+		d = (-linear + std::sqrt(linear * linear - 4.0f * quadratic * c)) / (2.0f * quadratic);
+	else if (linear > 0.0f)
+		d = -c / linear;
+	return std::min(d, MAX_RANGE);
 }
@@ -1,21 +1,38 @@
 #pragma once
 #include "Light.h"
-#include "Shader.h"
+
+// std140 layout of the GLSL PointLight struct
+struct PointLightStd140 {
+	LightStd140 base;
+	glm::vec3 position;
+	float constant;
+	float linear;
+	float quadratic;
+	float pad0[2];
+};
+static_assert(sizeof(PointLightStd140) == 96, "PointLightStd140 must match the std140 layout of PointLight");
 
 class PointLight : public Light {
 public:
-	PointLight(Shader &shader);
-	PointLight(Shader &shader,
+	PointLight();
+	PointLight(
 		glm::vec3 color,
 		glm::vec3 aIntensity, glm::vec3 dIntensity, glm::vec3 specular,
 		glm::vec3 position,
 		float constant, float linear, float quadratic);
 
-	void UseLight(unsigned int id);
+	void SetPosition(glm::vec3 position);
+
+	// distance at which the light falls below 1/256 of its peak, the radius used for culling
+	float Range() const;
+	// the same for any light, see Light::Peak()
+	static float AttenuationRange(float peak, float constant, float linear, float quadratic);
 
 	~PointLight() = default;
 
 protected:
+	friend class LightManager;
+
 	glm::vec3 Position;
 
 	float Constant, Linear, Quadratic;
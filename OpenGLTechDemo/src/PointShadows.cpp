@@ -0,0 +1,223 @@
+#include "PointShadows.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#include "Profiler.h"
+
+namespace {
+	const float NEAR_PLANE = 0.1f;
+
+	// view direction and up vector of every cube map face
+	const glm::vec3 FACE_DIRECTIONS[PointShadows::FACES] = {
+		glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(-1.0f, 0.0f, 0.0f),
+		glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f),
+		glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -1.0f)
+	};
+	const glm::vec3 FACE_UPS[PointShadows::FACES] = {
+		glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f),
+		glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -1.0f),
+		glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)
+	};
+
+	// smallest absolute value in [low, high]
+	float minAbs(float low, float high)
+	{
+		if (low <= 0.0f && high >= 0.0f)
+			return 0.0f;
+		return std::min(std::abs(low), std::abs(high));
+	}
+}
+
+PointShadows::PointShadows() : count(0), maxResolution(0), atlas(nullptr), atlasGeneration(0), nextFace(0)
+{
+	for (unsigned int i = 0; i < MAX_LIGHTS; i++) {
+		positions[i] = glm::vec3(0.0f);
+		farPlanes[i] = 1.0f;
+		importances[i] = 0.0f;
+		requested[i] = 0;
+		placed[i] = 0;
+		drawn[i] = 0;
+		scheduled[i] = 0;
+		for (unsigned int face = 0; face < FACES; face++) {
+			faceMatrices[i][face] = glm::mat4(1.0f);
+			drawnPositions[i][face] = glm::vec3(0.0f);
+			drawnFarPlanes[i][face] = 0.0f;
+		}
+	}
+}
+
+void PointShadows::Configure(unsigned int newCount, unsigned int newMaxResolution, ShadowAtlas &newAtlas)
+{
+	newCount = std::min(newCount, MAX_LIGHTS);
+
+	// a resized atlas dropped every tile
+	if (atlas != &newAtlas || atlasGeneration != newAtlas.Generation()) {
+		atlas = &newAtlas;
+		atlasGeneration = newAtlas.Generation();
+		for (unsigned int i = 0; i < MAX_LIGHTS; i++) {
+			for (unsigned int face = 0; face < FACES; face++)
+				tiles[i][face] = ShadowTile();
+			placed[i] = 0;
+			drawn[i] = 0;
+		}
+	}
+
+	for (unsigned int i = newCount; i < count; i++) {
+		freeFaces(i);
+		placed[i] = 0;
+		requested[i] = 0;
+	}
+	if (newCount != count)
+		nextFace = 0;
+	count = newCount;
+	maxResolution = newMaxResolution;
+}
+
+void PointShadows::SetLight(unsigned int light, const glm::vec3 &position, float farPlane, float importance)
+{
+	// the largest power of two up to the importance, a light close to a step keeps its
+	// resolution until it is clearly past it, every change draws all of its faces again
+	unsigned int current = requested[light];
+	if (current == 0 || current > maxResolution || importance < 0.75f * current || importance >= 2.5f * current) {
+		unsigned int resolution = ShadowAtlas::MIN_TILE;
+		while (resolution * 2 <= maxResolution && resolution * 2 <= importance)
+			resolution *= 2;
+		requested[light] = resolution;
+	}
+	importances[light] = importance;
+
+	if (positions[light] == position && farPlanes[light] == farPlane)
+		return;
+	positions[light] = position;
+	farPlanes[light] = farPlane;
+
+	glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, NEAR_PLANE, farPlane);
+	for (unsigned int face = 0; face < FACES; face++)
+		faceMatrices[light][face] = projection * glm::lookAt(position, position + FACE_DIRECTIONS[face], FACE_UPS[face]);
+}
+
+void PointShadows::AllocateTiles()
+{
+	PROFILE_FUNCTION();
+
+	// free every moving light first, so the more important ones can take their room
+	unsigned int order[MAX_LIGHTS];
+	unsigned int moving = 0;
+	for (unsigned int i = 0; i < count; i++) {
+		if (placed[i] == requested[i])
+			continue;
+		freeFaces(i);
+		order[moving++] = i;
+	}
+	std::sort(order, order + moving, [this](unsigned int a, unsigned int b) { return importances[a] > importances[b]; });
+
+	for (unsigned int i = 0; i < moving; i++) {
+		unsigned int light = order[i];
+		// smaller tiles when the atlas is full, none below its smallest
+		for (unsigned int resolution = requested[light]; resolution >= ShadowAtlas::MIN_TILE; resolution /= 2)
+			if (allocateFaces(light, resolution))
+				break;
+		placed[light] = requested[light];
+		drawn[light] = 0;
+	}
+}
+
+bool PointShadows::allocateFaces(unsigned int light, unsigned int resolution)
+{
+	for (unsigned int face = 0; face < FACES; face++) {
+		if (!atlas->Allocate(resolution, tiles[light][face])) {
+			freeFaces(light);
+			return false;
+		}
+	}
+	return true;
+}
+
+void PointShadows::freeFaces(unsigned int light)
+{
+	for (unsigned int face = 0; face < FACES; face++)
+		atlas->Free(tiles[light][face]);
+}
+
+glm::vec4 PointShadows::TileRect(unsigned int light, unsigned int face) const
+{
+	const ShadowTile &tile = tiles[light][face];
+	if (!tile.valid())
+		return glm::vec4(0.0f);
+	float size = (float)atlas->Size();
+	return glm::vec4(tile.x / size, tile.y / size, tile.size / size, 0.0f);
+}
+
+void PointShadows::Invalidate()
+{
+	for (unsigned int i = 0; i < MAX_LIGHTS; i++)
+		drawn[i] = 0;
+}
+
+bool PointShadows::stale(unsigned int light, unsigned int face) const
+{
+	// a light without tiles has nothing to draw
+	if (!tiles[light][face].valid())
+		return false;
+	return !(drawn[light] & (1u << face)) || drawnPositions[light][face] != positions[light] || drawnFarPlanes[light][face] != farPlanes[light];
+}
+
+unsigned int PointShadows::Schedule(unsigned int budget)
+{
+	PROFILE_FUNCTION();
+
+	for (unsigned int i = 0; i < MAX_LIGHTS; i++)
+		scheduled[i] = 0;
+
+	unsigned int faces = count * FACES, picked = 0;
+	for (unsigned int i = 0; i < faces && picked < budget; i++) {
+		unsigned int index = (nextFace + i) % faces;
+		unsigned int light = index / FACES, face = index % FACES;
+		if (!stale(light, face))
+			continue;
+
+		// drawn by the caller this frame
+		scheduled[light] |= 1u << face;
+		drawn[light] |= 1u << face;
+		drawnPositions[light][face] = positions[light];
+		drawnFarPlanes[light][face] = farPlanes[light];
+		picked++;
+		nextFace = (index + 1) % faces;
+	}
+	return picked;
+}
+
+void PointShadows::BeginLight(unsigned int light) const
+{
+	atlas->Bind();
+	for (unsigned int face = 0; face < FACES; face++)
+		if (scheduled[light] & (1u << face))
+			atlas->Clear(tiles[light][face]);
+}
+
+unsigned int PointShadows::FaceMask(unsigned int light, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax) const
+{
+	glm::vec3 low = boundsMin - positions[light], high = boundsMax - positions[light];
+
+	// nothing beyond the far plane is stored
+	glm::vec3 nearest = glm::clamp(glm::vec3(0.0f), low, high);
+	if (glm::dot(nearest, nearest) > farPlanes[light] * farPlanes[light])
+		return 0;
+
+	// A face sees the directions whose coordinate along its axis is at least the absolute value
+	// of the other two. The axes are independent, so the box reaches the +X face exactly when its
+	// largest x is at least the smallest |y| and the smallest |z| of the box, and so on.
+	glm::vec3 closest(minAbs(low.x, high.x), minAbs(low.y, high.y), minAbs(low.z, high.z));
+	unsigned int mask = 0;
+	for (int axis = 0; axis < 3; axis++) {
+		float others = std::max(closest[(axis + 1) % 3], closest[(axis + 2) % 3]);
+		if (high[axis] >= others && high[axis] > 0.0f)
+			mask |= 1u << (axis * 2);
+		if (-low[axis] >= others && low[axis] < 0.0f)
+			mask |= 1u << (axis * 2 + 1);
+	}
+	return mask & scheduled[light];
+}
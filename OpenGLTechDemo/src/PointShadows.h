@@ -0,0 +1,90 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include "ShadowAtlas.h"
+
+// Omnidirectional shadows of the point lights in the Lights block. Every light has six tiles in
+// the shadow atlas, one per cube face, holding the distance to the light divided by its far
+// plane. All faces a light needs in a frame are rendered in one pass: Shaders/pointShadowDepth.geom
+// copies every triangle to the faces in its faceMask and moves each copy into the face's tile,
+// clipped to it, and FaceMask() leaves out the faces a caster can't reach.
+// The tile size of a light follows how large its range appears on screen, up to the maximum
+// resolution, and the lights asking for the most texels are placed first, so when the atlas is
+// full the least important lights get smaller tiles or none. A light keeps its tiles and their
+// depth from frame to frame until its resolution changes.
+// A face is rendered again only once its light moved or Invalidate() was called, and at most
+// Schedule()'s budget of faces per frame, round robin over the faces of every light, so the cost
+// stays bounded as lights are added. Faces waiting for their turn keep last frame's depth.
+class PointShadows {
+public:
+	// must match MAX_POINT_SHADOWS in include/lights.glsl
+	static const unsigned int MAX_LIGHTS = 4;
+	static const unsigned int FACES = 6;
+	static const unsigned int ALL_FACES = (1u << FACES) - 1;
+
+	PointShadows();
+	PointShadows(const PointShadows&) = delete;
+	PointShadows& operator=(const PointShadows&) = delete;
+
+	// sets the number of shadowed lights, the largest tile a face may get and the atlas the
+	// tiles are taken from
+	void Configure(unsigned int count, unsigned int maxResolution, ShadowAtlas &atlas);
+	// the light's faces are stale once its position or far plane differ from when they were
+	// drawn, importance is the size in texels a face of it should have
+	void SetLight(unsigned int light, const glm::vec3 &position, float farPlane, float importance);
+	// moves the lights whose resolution changed to new tiles, the most important first
+	void AllocateTiles();
+	// the casters moved, every face is stale
+	void Invalidate();
+	// picks at most budget stale faces for this frame, continuing after the last frame's
+	// picks, returns how many were picked
+	unsigned int Schedule(unsigned int budget);
+	// bit per face of the light picked by Schedule()
+	unsigned int ScheduledFaces(unsigned int light) const { return scheduled[light]; }
+	// binds the atlas as depth target and clears the tiles of the scheduled faces, the other
+	// faces keep their depth
+	void BeginLight(unsigned int light) const;
+	// scheduled faces of the light whose frustum the world-space box reaches
+	unsigned int FaceMask(unsigned int light, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax) const;
+
+	unsigned int Count() const { return count; }
+	// texels per face, 0 if the atlas had no room for the light
+	unsigned int Resolution(unsigned int light) const { return tiles[light][0].size; }
+	const glm::vec3& Position(unsigned int light) const { return positions[light]; }
+	float FarPlane(unsigned int light) const { return farPlanes[light]; }
+	// view-projection of each face, in the order of GL_TEXTURE_CUBE_MAP_POSITIVE_X and on
+	const glm::mat4* FaceMatrices(unsigned int light) const { return faceMatrices[light]; }
+	// origin and size of the face's tile in texture coordinates of the atlas, all 0 without one
+	glm::vec4 TileRect(unsigned int light, unsigned int face) const;
+
+private:
+	unsigned int count;
+	unsigned int maxResolution;
+	ShadowAtlas* atlas;
+	// atlas generation the tiles were taken from
+	unsigned int atlasGeneration;
+	ShadowTile tiles[MAX_LIGHTS][FACES];
+
+	glm::vec3 positions[MAX_LIGHTS];
+	float farPlanes[MAX_LIGHTS];
+	glm::mat4 faceMatrices[MAX_LIGHTS][FACES];
+	// texels per face asked for by SetLight(), and the resolution the tiles were placed for
+	float importances[MAX_LIGHTS];
+	unsigned int requested[MAX_LIGHTS];
+	unsigned int placed[MAX_LIGHTS];
+	// position and far plane every face was drawn with
+	glm::vec3 drawnPositions[MAX_LIGHTS][FACES];
+	float drawnFarPlanes[MAX_LIGHTS][FACES];
+	// bit per face drawn since the last Invalidate()
+	unsigned int drawn[MAX_LIGHTS];
+	unsigned int scheduled[MAX_LIGHTS];
+	// face Schedule() starts looking at, light * FACES + face
+	unsigned int nextFace;
+
+	bool stale(unsigned int light, unsigned int face) const;
+	bool allocateFaces(unsigned int light, unsigned int resolution);
+	void freeFaces(unsigned int light);
+};
@@ -0,0 +1,169 @@
+#include "Profiler.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+	// events kept per thread, older ones are overwritten
+	const unsigned long long RING_SIZE = 1 << 16;
+	// the ring is allocated a chunk at a time as it fills, so threads recording a few zones stay small
+	const unsigned long long CHUNK_SIZE = 1 << 10;
+	const unsigned long long CHUNK_COUNT = RING_SIZE / CHUNK_SIZE;
+
+	struct ZoneEvent {
+		const char* name;
+		unsigned long long start;
+		unsigned long long duration;
+		unsigned int depth;
+	};
+
+	struct ThreadBuffer {
+		// only the owning thread allocates chunks, before publishing the events written into them
+		std::atomic<ZoneEvent*> chunks[CHUNK_COUNT];
+		// total number of events ever written, only the owning thread stores to it
+		std::atomic<unsigned long long> head;
+		unsigned int threadId;
+		unsigned int depth;
+		const char* name;
+
+		~ThreadBuffer()
+		{
+			for (unsigned long long c = 0; c < CHUNK_COUNT; c++)
+				delete[] chunks[c].load();
+		}
+
+		ZoneEvent &event(unsigned long long index)
+		{
+			std::atomic<ZoneEvent*> &chunk = chunks[(index % RING_SIZE) / CHUNK_SIZE];
+			ZoneEvent* events = chunk.load(std::memory_order_acquire);
+			if (!events) {
+				events = new ZoneEvent[CHUNK_SIZE];
+				chunk.store(events, std::memory_order_release);
+			}
+			return events[index % CHUNK_SIZE];
+		}
+	};
+
+	// buffers stay alive after their thread exits so the trace can still be exported
+	std::mutex registryMutex;
+	std::vector<std::unique_ptr<ThreadBuffer> > registry;
+
+	const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+	unsigned long long now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+	}
+
+	ThreadBuffer* threadBuffer()
+	{
+		thread_local ThreadBuffer* buffer = nullptr;
+		if (buffer)
+			return buffer;
+
+		// registration happens once per thread, recording itself never locks
+		std::unique_ptr<ThreadBuffer> created(new ThreadBuffer());
+		for (unsigned long long c = 0; c < CHUNK_COUNT; c++)
+			created->chunks[c].store(nullptr);
+		created->head.store(0);
+		created->depth = 0;
+		created->name = nullptr;
+
+		std::lock_guard<std::mutex> lock(registryMutex);
+		created->threadId = (unsigned int)registry.size() + 1;
+		buffer = created.get();
+		registry.push_back(std::move(created));
+		return buffer;
+	}
+
+	void writeEscaped(std::ostream &out, const char* text)
+	{
+		for (; *text; text++) {
+			if (*text == '"' || *text == '\\')
+				out << '\\';
+			out << *text;
+		}
+	}
+}
+
+ProfileZone::ProfileZone(const char* name) : name(name)
+{
+	threadBuffer()->depth++;
+	start = now();
+}
+
+ProfileZone::~ProfileZone()
+{
+	unsigned long long end = now();
+	ThreadBuffer* buffer = threadBuffer();
+	buffer->depth--;
+
+	unsigned long long head = buffer->head.load(std::memory_order_relaxed);
+	ZoneEvent &event = buffer->event(head);
+	event.name = name;
+	event.start = start;
+	event.duration = end - start;
+	event.depth = buffer->depth;
+	// publish the event to readers only once it is fully written
+	buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::SetThreadName(const char* name)
+{
+	threadBuffer()->name = name;
+}
+
+bool Profiler::ExportChromeTrace(const std::string &path)
+{
+	std::ofstream out(path.c_str());
+	if (!out) {
+		std::cout << "Error::Profiler: could not write " << path << std::endl;
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(registryMutex);
+
+	out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+	bool first = true;
+	size_t exported = 0;
+	for (size_t t = 0; t < registry.size(); t++) {
+		ThreadBuffer &buffer = *registry[t];
+
+		if (buffer.name) {
+			out << (first ? "" : ",") << "\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer.threadId << ", \"args\": {\"name\": \"";
+			writeEscaped(out, buffer.name);
+			out << "\"}}";
+			first = false;
+		}
+
+		unsigned long long head = buffer.head.load(std::memory_order_acquire);
+		unsigned long long begin = head > RING_SIZE ? head - RING_SIZE : 0;
+		std::vector<ZoneEvent> events;
+		for (unsigned long long i = begin; i < head; i++)
+			events.push_back(buffer.chunks[(i % RING_SIZE) / CHUNK_SIZE].load(std::memory_order_acquire)[i % CHUNK_SIZE]);
+
+		// the owning thread may have wrapped around while we copied, drop what it overwrote
+		unsigned long long after = buffer.head.load(std::memory_order_acquire);
+		size_t skip = after > begin + RING_SIZE ? (size_t)(after - begin - RING_SIZE) : 0;
+
+		for (size_t i = skip; i < events.size(); i++) {
+			out << (first ? "" : ",") << "\n{\"name\": \"";
+			writeEscaped(out, events[i].name);
+			out << "\", \"cat\": \"cpu\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer.threadId
+				<< ", \"ts\": " << events[i].start / 1000.0
+				<< ", \"dur\": " << events[i].duration / 1000.0
+				<< ", \"args\": {\"depth\": " << events[i].depth << "}}";
+			first = false;
+			exported++;
+		}
+	}
+	out << "\n]}\n";
+
+	std::cout << "Profiler: wrote " << exported << " zones to " << path << std::endl;
+	return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+
+// CPU profiling zones.
+// PROFILE_ZONE("name") times the rest of the enclosing scope and records it into a ring buffer
+// owned by the calling thread, so recording takes no locks. Zones nest. Names must outlive the
+// program (string literals, __FUNCTION__). Define DISABLE_PROFILE_ZONES to compile them out.
+#ifndef DISABLE_PROFILE_ZONES
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__FUNCTION__)
+#else
+#define PROFILE_ZONE(name)
+#define PROFILE_FUNCTION()
+#endif
+
+class ProfileZone {
+public:
+	ProfileZone(const char* name);
+	~ProfileZone();
+
+private:
+	const char* name;
+	unsigned long long start;
+};
+
+namespace Profiler {
+	// name shown for the calling thread in the trace viewer
+	void SetThreadName(const char* name);
+
+	// writes every zone still held in the ring buffers in the Chrome trace event format,
+	// which chrome://tracing and ui.perfetto.dev can open
+	bool ExportChromeTrace(const std::string &path);
+}
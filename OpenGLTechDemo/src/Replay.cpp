@@ -0,0 +1,189 @@
+#include "Replay.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "Scene.h"
+
+const float Replay::TIME_STEP = 1.0f / 60.0f;
+
+namespace {
+	const char REPLAY_MAGIC[4] = { 'O', 'G', 'R', 'P' };
+	// 2 added the settings window
+	const unsigned int REPLAY_VERSION = 2;
+
+	struct ReplayHeader {
+		char magic[4];
+		unsigned int version;
+		unsigned int frameSize;
+		unsigned int frameCount;
+		float timeStep;
+	};
+
+	static_assert(sizeof(ReplayFrame) == 156, "ReplayFrame is written to disk as is");
+
+	void copyVec3(float* out, const glm::vec3 &value)
+	{
+		out[0] = value.x;
+		out[1] = value.y;
+		out[2] = value.z;
+	}
+
+	void captureSettings(ReplaySettings &settings)
+	{
+		copyVec3(settings.mirrorTranslate, MTranslate);
+		copyVec3(settings.refractTranslate, RTranslate);
+		copyVec3(settings.lightPosition, lightPos);
+		settings.clearColor[0] = clearColor.x;
+		settings.clearColor[1] = clearColor.y;
+		settings.clearColor[2] = clearColor.z;
+		settings.clearColor[3] = clearColor.w;
+		settings.activeKernel = (int)activeKernel;
+		settings.blinnPhong = blinnPhong ? 1 : 0;
+		settings.shadows = shadows ? 1 : 0;
+		settings.shadowFilter = shadowFilter;
+		settings.pcfKernel = pcfKernel;
+		settings.shadowCascades = shadowCascadeCount;
+		settings.shadowMapSize = shadowMapSize;
+		settings.shadowDistance = shadowDistance;
+		settings.shadowCache = shadowCache ? 1 : 0;
+		settings.evsmBlur = shadowMoments.BlurRadius;
+		settings.pointLightShadows = pointLightShadows ? 1 : 0;
+		settings.pointShadowFaces = pointShadowFaceBudget;
+		settings.shadowAtlasSize = shadowAtlasSize;
+		settings.clusteredShading = clusteredShading ? 1 : 0;
+		settings.extraLights = extraLights;
+		settings.deferredShading = deferredShading ? 1 : 0;
+	}
+
+	void applySettings(const ReplaySettings &settings)
+	{
+		MTranslate = glm::vec3(settings.mirrorTranslate[0], settings.mirrorTranslate[1], settings.mirrorTranslate[2]);
+		RTranslate = glm::vec3(settings.refractTranslate[0], settings.refractTranslate[1], settings.refractTranslate[2]);
+		lightPos = glm::vec3(settings.lightPosition[0], settings.lightPosition[1], settings.lightPosition[2]);
+		clearColor = ImVec4(settings.clearColor[0], settings.clearColor[1], settings.clearColor[2], settings.clearColor[3]);
+		activeKernel = (unsigned int)settings.activeKernel;
+		blinnPhong = settings.blinnPhong != 0;
+		shadows = settings.shadows != 0;
+		shadowFilter = settings.shadowFilter;
+		pcfKernel = settings.pcfKernel;
+		shadowCascadeCount = settings.shadowCascades;
+		shadowMapSize = settings.shadowMapSize;
+		shadowDistance = settings.shadowDistance;
+		shadowCache = settings.shadowCache != 0;
+		shadowMoments.BlurRadius = settings.evsmBlur;
+		pointLightShadows = settings.pointLightShadows != 0;
+		pointShadowFaceBudget = settings.pointShadowFaces;
+		shadowAtlasSize = settings.shadowAtlasSize;
+		clusteredShading = settings.clusteredShading != 0;
+		extraLights = settings.extraLights;
+		deferredShading = settings.deferredShading != 0;
+	}
+}
+
+Replay::Replay() : frameIndex(0), recording(false), playing(false)
+{
+}
+
+bool Replay::StartRecording(const std::string &path)
+{
+	this->path = path;
+	frames.clear();
+	frameIndex = 0;
+	recording = true;
+	playing = false;
+	std::cout << "Replay: recording to " << path << std::endl;
+	return true;
+}
+
+bool Replay::StartPlayback(const std::string &path)
+{
+	std::ifstream in(path.c_str(), std::ios::binary);
+	ReplayHeader header;
+	if (!in || !in.read((char*)&header, sizeof(header))) {
+		std::cout << "Error::Replay: could not read " << path << std::endl;
+		return false;
+	}
+	if (std::memcmp(header.magic, REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0 || header.version != REPLAY_VERSION || header.frameSize != sizeof(ReplayFrame)) {
+		std::cout << "Error::Replay: " << path << " is not a replay of this version." << std::endl;
+		return false;
+	}
+	if (header.timeStep != TIME_STEP)
+		std::cout << "Replay: " << path << " was recorded with a time step of " << header.timeStep << " s, playing it at " << TIME_STEP << " s." << std::endl;
+
+	frames.resize(header.frameCount);
+	if (header.frameCount > 0 && !in.read((char*)&frames[0], header.frameCount * sizeof(ReplayFrame))) {
+		std::cout << "Error::Replay: " << path << " is truncated." << std::endl;
+		frames.clear();
+		return false;
+	}
+
+	this->path = path;
+	frameIndex = 0;
+	playing = true;
+	recording = false;
+	std::cout << "Replay: playing " << frames.size() << " frames from " << path << std::endl;
+	return true;
+}
+
+bool Replay::Stop()
+{
+	bool wasRecording = recording;
+	recording = false;
+	playing = false;
+	if (!wasRecording)
+		return true;
+
+	std::ofstream out(path.c_str(), std::ios::binary);
+	if (!out) {
+		std::cout << "Error::Replay: could not write " << path << std::endl;
+		return false;
+	}
+
+	ReplayHeader header;
+	std::memcpy(header.magic, REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+	header.version = REPLAY_VERSION;
+	header.frameSize = sizeof(ReplayFrame);
+	header.frameCount = (unsigned int)frames.size();
+	header.timeStep = TIME_STEP;
+	out.write((const char*)&header, sizeof(header));
+	if (!frames.empty())
+		out.write((const char*)&frames[0], frames.size() * sizeof(ReplayFrame));
+
+	std::cout << "Replay: wrote " << frames.size() << " frames to " << path << std::endl;
+	return true;
+}
+
+void Replay::Capture(const Camera &camera, unsigned int keys, float mouseX, float mouseY, float scroll)
+{
+	if (!recording)
+		return;
+
+	ReplayFrame frame;
+	frame.position[0] = camera.Position.x;
+	frame.position[1] = camera.Position.y;
+	frame.position[2] = camera.Position.z;
+	frame.yaw = camera.Yaw;
+	frame.pitch = camera.Pitch;
+	frame.zoom = camera.Zoom;
+	frame.mouseX = mouseX;
+	frame.mouseY = mouseY;
+	frame.scroll = scroll;
+	frame.keys = keys;
+	captureSettings(frame.settings);
+	frames.push_back(frame);
+}
+
+bool Replay::Apply(Camera &camera, bool settings)
+{
+	if (!playing || frameIndex >= frames.size())
+		return false;
+
+	// the recorded camera state is restored as is, replaying the input would drift with float error
+	const ReplayFrame &frame = frames[frameIndex];
+	camera.SetState(glm::vec3(frame.position[0], frame.position[1], frame.position[2]), frame.yaw, frame.pitch, frame.zoom);
+	if (settings)
+		applySettings(frame.settings);
+	return true;
+}
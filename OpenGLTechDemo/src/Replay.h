@@ -0,0 +1,91 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Camera.h"
+
+// input captured in a frame, bit per key
+enum ReplayKeys {
+	REPLAY_KEY_FORWARD	= 1 << 0,
+	REPLAY_KEY_BACKWARD	= 1 << 1,
+	REPLAY_KEY_LEFT		= 1 << 2,
+	REPLAY_KEY_RIGHT	= 1 << 3
+};
+
+// the settings of the settings window, recorded every frame
+struct ReplaySettings {
+	float mirrorTranslate[3];
+	float refractTranslate[3];
+	float lightPosition[3];
+	float clearColor[4];
+	int activeKernel;
+	int blinnPhong;
+	int shadows;
+	int shadowFilter;
+	int pcfKernel;
+	int shadowCascades;
+	int shadowMapSize;
+	float shadowDistance;
+	int shadowCache;
+	int evsmBlur;
+	int pointLightShadows;
+	int pointShadowFaces;
+	int shadowAtlasSize;
+	int clusteredShading;
+	int extraLights;
+	int deferredShading;
+};
+
+// everything that changes what a frame renders; 156 bytes on disk
+struct ReplayFrame {
+	float position[3];
+	float yaw;
+	float pitch;
+	float zoom;
+	// raw input of the frame, kept so a recording can be inspected or re-simulated
+	float mouseX;
+	float mouseY;
+	float scroll;
+	unsigned int keys;
+	ReplaySettings settings;
+};
+
+// Records the camera, input and settings of every frame into a compact binary file and plays
+// them back.
+// Both modes run the scene on a fixed simulated clock (frame * TIME_STEP), so replaying a file
+// renders exactly the same frames on every run and timings can be compared across commits.
+class Replay {
+public:
+	static const float TIME_STEP;
+
+	Replay();
+
+	bool StartRecording(const std::string &path);
+	bool StartPlayback(const std::string &path);
+	// writes the recording to disk
+	bool Stop();
+
+	bool IsRecording() const { return recording; }
+	bool IsPlaying() const { return playing; }
+	bool Finished() const { return playing && frameIndex >= frames.size(); }
+	unsigned int FrameCount() const { return (unsigned int)frames.size(); }
+
+	// time of the current frame on the simulated clock
+	float SimulatedTime() const { return frameIndex * TIME_STEP; }
+
+	// recording: stores the state of the frame that is about to be rendered
+	void Capture(const Camera &camera, unsigned int keys, float mouseX, float mouseY, float scroll);
+	// playback: restores the next recorded frame into the camera and, with settings, the scene
+	// settings as well
+	bool Apply(Camera &camera, bool settings = true);
+	// call once the frame is rendered
+	void NextFrame() { frameIndex++; }
+
+private:
+	std::vector<ReplayFrame> frames;
+	std::string path;
+	size_t frameIndex;
+	bool recording;
+	bool playing;
+};
@@ -0,0 +1,1495 @@
+#include "Scene.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+#include <map>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include "Material.h"
+#include "Light.h"
+#include "DirectionalLight.h"
+#include "PointLight.h"
+#include "SpotLight.h"
+#include "FrameUniforms.h"
+#include "ClusteredLights.h"
+#include "Profiler.h"
+
+PassCallback passCallback = nullptr;
+
+// define models
+Model house;
+Model ori;
+// vertex layout the models are loaded with, read by loadScene
+VertexLayout modelVertexLayout = PackedVertexLayout;
+// reorder the models' meshes for the vertex cache, overdraw and fetch when loading them
+bool optimizeMeshes = true;
+
+const unsigned int SCR_WIDTH = 1280, SCR_HEIGHT = 720;
+
+// camera
+Camera camera = Camera(glm::vec3(0.0f, 10.0f, -20.0f), glm::vec3(0.0f, 1.0f, 0.0f), 0.0f, 0.0f);
+
+// timing
+float sceneTime = 0.0f;
+
+// max number of lights
+const unsigned int NR_POINT_LIGHTS = LightBlockStd140::MAX_POINT_LIGHTS;
+const unsigned int NR_SPOT_LIGHTS = LightBlockStd140::MAX_SPOT_LIGHTS;
+
+// 
+glm::vec3 pointLightPositions[] = {
+	glm::vec3(1.61f,  2.41f, -13.09f),
+	glm::vec3(1.61f,  8.06f, -13.09f),
+	glm::vec3(1.61f,  2.41f, -19.44f),
+	glm::vec3(1.61f,  8.06f, -19.44f)
+};
+
+// the shadow of the directional light falls from lightPos towards the origin
+glm::vec3 lightPos(-14.5f, 15.3f, -25.0f);
+// cascaded shadow maps, more and larger cascades trade shadow pass time for sharper shadows
+int shadowCascadeCount = 3;
+int shadowMapSize = 2048;
+float shadowDistance = 80.0f;
+ShadowCascades shadowCascades;
+// keep the depth of the static casters between frames, only the light cubes are drawn every frame
+bool shadowCache = true;
+// transforms of the static casters the cache was drawn with, see invalidateMovedCasters()
+const unsigned int STATIC_CASTER_TRANSFORMS = 8;
+glm::vec3 cachedCasterTransforms[STATIC_CASTER_TRANSFORMS];
+// light frustum of the cascade being drawn, nullptr outside the shadow pass
+const glm::mat4* shadowCullMatrix = nullptr;
+
+// shared by the point light shadows, 2048 holds four lights with 256 texel faces
+int shadowAtlasSize = 2048;
+ShadowAtlas shadowAtlas;
+// atlas shadows of the scene's point lights, at most pointShadowFaceBudget faces are drawn
+// per frame
+bool pointLightShadows = true;
+int pointShadowSize = 512;
+int pointShadowFaceBudget = 12;
+PointShadows pointShadows;
+// light whose faces are being drawn, -1 outside the point shadow pass
+int pointShadowCullLight = -1;
+// blurred moments of the cascades, the penumbra of the EVSM filter
+ShadowMoments shadowMoments;
+
+// the objects of the scene and the passes they are drawn in
+const SceneObject sceneObjects[] = {
+	{ "drawCubes",		MainPass | ShadowCasterPass,					drawCubes },
+	{ "drawFloor",		MainPass | ShadowCasterPass,					drawFloor },
+	{ "drawLightCube",	MainPass | ShadowCasterPass | DynamicObject,	drawLightCube },
+	{ "drawModels",		MainPass | ShadowCasterPass,					drawModels },
+	// alpha blended quads, their depth would cast a solid rectangle
+	{ "drawGrasses",	MainPass | TransparentPass,						drawGrasses },
+	{ "drawWindows",	MainPass | TransparentPass,						drawWindows },
+	{ "drawSkybox",		MainPass,										drawSkybox }
+};
+const unsigned int SCENE_OBJECT_COUNT = sizeof(sceneObjects) / sizeof(sceneObjects[0]);
+
+// vfxFramebuffer() uses these
+unsigned int activeKernel = 0;
+unsigned int framebuffer, textureColorbuffer, quadVAO = 0, quadVBO = 0;
+
+// framebuffer the final image is rendered into
+unsigned int sceneFBO = 0;
+
+// active lighting method (Phong or BlinnPhong)
+bool blinnPhong = true;
+bool shadows = true;
+int shadowFilter = ShadowFilterBox;
+int pcfKernel = 3;
+
+
+// ImGUI state
+// ----------------------------------------------	
+ImVec4 clearColor = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
+// house
+glm::vec3	HRotateAxis = glm::vec3(1.0f, 0.0f, 0.0f);
+float		HRotateAngle = 360.0f;
+glm::vec3	HTranslate = glm::vec3(1.0f);
+// ori
+glm::vec3	ORotateAxis = glm::vec3(0.0f, 1.0f, 0.0f);
+float		ORotateAngle = 90.0f;
+glm::vec3	OTranslate = glm::vec3(14.0f, 1.0f, 1.0f);
+// floor
+glm::vec3	FTranslate = glm::vec3(15.0f, -48.96f, 0.0f);
+glm::vec3	FRotateAxis = glm::vec3(1.0f, 0.0f, 0.0f);
+float		FRotate = 90.0f;
+
+// light colors
+glm::vec3	lightColors[] = {
+		glm::vec3(0.15f, 0.43, 0.89), // blue
+		glm::vec3(0.15f, 0.89, 0.33), // green
+		glm::vec3(1.00f, 1.00, 0.15), // yellow
+		glm::vec3(1.00f, 0.15, 0.15)  // red
+};
+
+// lights of the scene, only the ones that changed are uploaded into the Lights uniform block
+LightManager lightManager;
+// id of the camera's flashlight, the point lights come first
+unsigned int flashlight;
+// lights added after the scene's own ones, scattered over the floor
+int extraLights = 0;
+unsigned int sceneLightCount;
+
+// clustered shading
+bool clusteredShading = true;
+ClusteredLights clusteredLights;
+
+// deferred shading
+bool deferredShading = false;
+unsigned int gbufferFBO = 0, gAlbedoShininess, gNormal, gDepth;
+
+// mirror pos
+glm::vec3	MTranslate = glm::vec3(25.0f, 0.5f, -15.0f);
+glm::vec3	RTranslate = glm::vec3(15.0f, -48.96f, 0.0f);
+
+// projection and view matrices
+float cameraNear = 0.1f, cameraFar = 100.0f;
+glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, cameraNear, cameraFar);
+glm::mat4 view = camera.GetViewMatrix();
+
+// camera and shadow matrices shared by every shader
+FrameUniformBuffer frameUniforms;
+
+// notifies passCallback for the lifetime of a pass
+struct ScopedPass {
+	const char* name;
+
+	ScopedPass(const char* name) : name(name)
+	{
+		if (passCallback)
+			passCallback(name, true);
+	}
+
+	~ScopedPass()
+	{
+		if (passCallback)
+			passCallback(name, false);
+	}
+};
+
+void loadScene(SceneShaders &shaders)
+{
+	ShaderBatch batch;
+	loadScene(shaders, batch);
+	batch.Finish();
+}
+
+void loadScene(SceneShaders &shaders, ShaderBatch &batch)
+{
+	PROFILE_FUNCTION();
+
+	// queue every shader, the driver compiles them while the models load
+	shaders.lighting		= ShaderPermutations("Shaders/lighting.vert",	"Shaders/lighting.frag");
+	shaders.model			= ShaderPermutations("Shaders/modelShader.vert",	"Shaders/modelShader.frag");
+	shaders.deferred		= ShaderPermutations("Shaders/deferred.vert",		"Shaders/deferred.frag");
+	batch.Add(&shaders.lightCube,		"Shaders/light_cube.vert",			"Shaders/light_cube.frag");
+	batch.Add(&shaders.blending,		"Shaders/blending.vert",			"Shaders/blending.frag");
+	batch.Add(&shaders.framebuffer,		"Shaders/framebuffer.vert",			"Shaders/framebuffer.frag");
+	batch.Add(&shaders.skybox,			"Shaders/skybox.vert",				"Shaders/skybox.frag");
+	batch.Add(&shaders.reflect,			"Shaders/reflect.vert",				"Shaders/reflect.frag");
+	batch.Add(&shaders.refract,			"Shaders/refract.vert",				"Shaders/refract.frag");
+	batch.Add(&shaders.depth,			"Shaders/dirShadowMapDepth.vert",	"Shaders/dirShadowMapDepth.frag");
+	batch.Add(&shaders.pointDepth,		"Shaders/pointShadowDepth.vert",	"Shaders/pointShadowDepth.frag",	std::string(), "Shaders/pointShadowDepth.geom");
+	batch.Add(&shaders.momentsFromDepth,	"Shaders/deferred.vert",			"Shaders/shadowMoments.frag",		"#define FROM_DEPTH\n");
+	batch.Add(&shaders.momentsBlur,		"Shaders/deferred.vert",			"Shaders/shadowMoments.frag");
+	batch.Add(&shaders.debugDepthQuad,	"Shaders/debug_quad.vert",			"Shaders/debug_quad.frag");
+	// the permutations of the start settings
+	if (deferredShading) {
+		shaders.lighting.Add(gbufferFeatures(), batch);
+		shaders.model.Add(gbufferFeatures(), batch);
+		shaders.deferred.Add(litFeatures(), batch);
+	} else {
+		shaders.lighting.Add(litFeatures(), batch);
+		shaders.model.Add(litFeatures(), batch);
+	}
+	batch.Submit();
+
+	// load models
+	house = Model("Resources/Models/House/house.obj", false, modelVertexLayout, optimizeMeshes);
+	ori = Model("Resources/Models/Ori/ori.obj", false, modelVertexLayout, optimizeMeshes);
+
+	// set up the lights, updateLights moves them every frame
+	lightManager.Truncate(0);
+	lightManager.SetDirectionalLight(DirectionalLight(glm::vec3(1.0f), glm::vec3(0.05f, 0.05f, 0.05f), glm::vec3(0.4f, 0.4f, 0.4f), glm::vec3(0.5f, 0.5f, 0.5f), glm::vec3(5.0f, -4.0f, 1.0f)));
+	for (unsigned int i = 0; i < NR_POINT_LIGHTS; ++i)
+		lightManager.AddPointLight(PointLight(lightColors[i], glm::vec3(0.05f, 0.05f, 0.05f), glm::vec3(0.8f, 0.8f, 0.8f), glm::vec3(1.0f), pointLightPositions[i], 1.0f, 0.09, 0.032));
+	flashlight = lightManager.AddSpotLight(SpotLight(glm::vec3(1.0f), glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(1.0f), camera.Position, camera.Front, 1.0f, 0.09, 0.032, glm::cos(glm::radians(12.5f)), glm::cos(glm::radians(15.0f))));
+	sceneLightCount = lightManager.Count();
+
+	// configure post processing effects framebuffer
+	vfxFramebuffer();
+
+	// configure G-buffer FBO
+	gbufferFramebuffer();
+}
+
+ShaderFeatures litFeatures()
+{
+	ShaderFeatures features;
+	features.blinnPhong = blinnPhong;
+	features.shadows = shadows;
+	features.shadowFilter = (unsigned int)glm::clamp(shadowFilter, 0, SHADOW_FILTER_COUNT - 1);
+	features.pcfKernel = (unsigned int)glm::clamp(pcfKernel | 1, 1, 15);
+	features.pointLights = NR_POINT_LIGHTS;
+	features.spotLights = NR_SPOT_LIGHTS;
+	features.clustered = clusteredShading;
+	features.shadowCascades = (unsigned int)glm::clamp(shadowCascadeCount, 1, (int)ShadowCascades::MAX_CASCADES);
+	// the shadows setting turns every shadow off
+	features.pointShadows = shadows && pointLightShadows;
+	return features;
+}
+
+ShaderFeatures gbufferFeatures()
+{
+	// the light features don't change what is written, so there is a single permutation
+	ShaderFeatures features;
+	features.gbuffer = true;
+	return features;
+}
+
+// handles of the point shadow uniforms of a lit shader permutation
+struct PointShadowUniforms {
+	UniformHandle atlas;
+	UniformHandle farPlanes[PointShadows::MAX_LIGHTS];
+	UniformHandle lights[PointShadows::MAX_LIGHTS];
+	UniformHandle tiles[PointShadows::MAX_LIGHTS * PointShadows::FACES];
+};
+
+// resolved on the first draw with the program, the permutations live as long as the scene
+const PointShadowUniforms& pointShadowUniforms(const Shader &shader)
+{
+	static std::map<unsigned int, PointShadowUniforms> programs;
+	std::map<unsigned int, PointShadowUniforms>::iterator found = programs.find(shader.ID);
+	if (found != programs.end())
+		return found->second;
+
+	PointShadowUniforms &uniforms = programs[shader.ID];
+	uniforms.atlas = shader.getUniform("pointShadowAtlas");
+	for (unsigned int i = 0; i < PointShadows::MAX_LIGHTS; i++) {
+		std::string index = "[" + std::to_string(i) + "]";
+		uniforms.farPlanes[i] = shader.getUniform("pointShadowFarPlanes" + index);
+		uniforms.lights[i] = shader.getUniform("pointShadowLights" + index);
+	}
+	for (unsigned int i = 0; i < PointShadows::MAX_LIGHTS * PointShadows::FACES; i++)
+		uniforms.tiles[i] = shader.getUniform("pointShadowTiles[" + std::to_string(i) + "]");
+	return uniforms;
+}
+
+// texture units of the shadow maps and the clustered light lists, unused ones are ignored
+void setLitSamplers(Shader &shader)
+{
+	shader.setInt("shadowMap", ShadowMapUnit - GL_TEXTURE0);
+	shader.setInt("shadowMoments", ShadowMomentsUnit - GL_TEXTURE0);
+	shader.setInt("clusterLightData", ClusterLightDataUnit - GL_TEXTURE0);
+	shader.setInt("clusterGrid", ClusterGridUnit - GL_TEXTURE0);
+	shader.setInt("clusterLightIndices", ClusterIndexUnit - GL_TEXTURE0);
+
+	const PointShadowUniforms &uniforms = pointShadowUniforms(shader);
+	if (!uniforms.atlas.valid())
+		return;
+	shader.setInt(uniforms.atlas, ShadowAtlasUnit - GL_TEXTURE0);
+	for (unsigned int i = 0; i < PointShadows::MAX_LIGHTS; i++) {
+		shader.setFloat(uniforms.farPlanes[i], pointShadows.FarPlane(i));
+		// the shadows not in use match no light
+		shader.setInt(uniforms.lights[i], i < pointShadows.Count() ? lightManager.BlockPointLight(i) : -1);
+		for (unsigned int face = 0; face < PointShadows::FACES; face++) {
+			glm::vec4 tile = i < pointShadows.Count() ? pointShadows.TileRect(i, face) : glm::vec4(0.0f);
+			shader.setVec4(uniforms.tiles[i * PointShadows::FACES + face], tile);
+		}
+	}
+}
+
+// world-space box around a model-space box
+void transformBounds(const glm::mat4 &model, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax, glm::vec3 &worldMin, glm::vec3 &worldMax)
+{
+	glm::vec3 center = glm::vec3(model * glm::vec4((boundsMin + boundsMax) * 0.5f, 1.0f));
+	glm::vec3 extent = (boundsMax - boundsMin) * 0.5f;
+	glm::mat3 axes = glm::mat3(model);
+	glm::vec3 worldExtent = glm::abs(axes[0]) * extent.x + glm::abs(axes[1]) * extent.y + glm::abs(axes[2]) * extent.z;
+	worldMin = center - worldExtent;
+	worldMax = center + worldExtent;
+}
+
+// the lights of the Lights block the next draws are shaded with
+void setDrawLights(Shader &shader, const DrawLights &lights)
+{
+	static std::string pointNames[LightManager::MAX_POINT_LIGHTS], spotNames[LightManager::MAX_SPOT_LIGHTS];
+	if (pointNames[0].empty()) {
+		for (unsigned int i = 0; i < LightManager::MAX_POINT_LIGHTS; i++)
+			pointNames[i] = "drawPointLights[" + std::to_string(i) + "]";
+		for (unsigned int i = 0; i < LightManager::MAX_SPOT_LIGHTS; i++)
+			spotNames[i] = "drawSpotLights[" + std::to_string(i) + "]";
+	}
+
+	shader.setInt("drawPointLightCount", (int)lights.pointCount);
+	for (unsigned int i = 0; i < lights.pointCount; i++)
+		shader.setInt(pointNames[i], lights.pointLights[i]);
+	shader.setInt("drawSpotLightCount", (int)lights.spotCount);
+	for (unsigned int i = 0; i < lights.spotCount; i++)
+		shader.setInt(spotNames[i], lights.spotLights[i]);
+}
+
+// culls the lights of the Lights block against a model-space box and sets the survivors
+void setDrawLights(Shader &shader, const DrawLights &candidates, const glm::mat4 &model, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax, DrawLights &out)
+{
+	glm::vec3 worldMin, worldMax;
+	transformBounds(model, boundsMin, boundsMax, worldMin, worldMax);
+	lightManager.CullBlockLights(candidates, worldMin, worldMax, out);
+	setDrawLights(shader, out);
+}
+
+// draws every mesh of the model, lit by the lights reaching the model and then the mesh
+void drawLitModel(Shader &shader, Model &object, const glm::mat4 &model)
+{
+	if (shadowCulled(shader, model, object.BoundsMin, object.BoundsMax))
+		return;
+
+	// the clustered, G-buffer and depth shaders have no per-draw light lists
+	if (!shader.getUniform("drawPointLightCount").valid()) {
+		// the shadow passes only read positions
+		bool depthOnly = shadowCullMatrix != nullptr || pointShadowCullLight >= 0;
+		for (size_t i = 0; i < object.meshes.size(); i++) {
+			if (shadowCulled(shader, model, object.meshes[i].BoundsMin, object.meshes[i].BoundsMax))
+				continue;
+			if (depthOnly)
+				object.meshes[i].DrawDepth();
+			else
+				object.meshes[i].Draw(shader);
+		}
+		return;
+	}
+
+	DrawLights objectLights, meshLights;
+	lightManager.BlockLights(objectLights);
+	glm::vec3 worldMin, worldMax;
+	transformBounds(model, object.BoundsMin, object.BoundsMax, worldMin, worldMax);
+	lightManager.CullBlockLights(objectLights, worldMin, worldMax, objectLights);
+	for (size_t i = 0; i < object.meshes.size(); i++) {
+		setDrawLights(shader, objectLights, model, object.meshes[i].BoundsMin, object.meshes[i].BoundsMax, meshLights);
+		object.meshes[i].Draw(shader);
+	}
+}
+
+// draws the floor and the models into the G-buffer, then lights every pixel of it into target
+void drawDeferred(SceneShaders &shaders, unsigned int target)
+{
+	{
+		ScopedPass pass("gbuffer");
+		PROFILE_ZONE("gbuffer");
+		glBindFramebuffer(GL_FRAMEBUFFER, gbufferFBO);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		{ ScopedPass pass("drawFloor");		drawFloor(shaders.lighting.Get(gbufferFeatures())); }
+		{ ScopedPass pass("drawModels");	drawModels(shaders.model.Get(gbufferFeatures())); }
+	}
+
+	{
+		ScopedPass pass("deferredLighting");
+		PROFILE_ZONE("deferredLighting");
+		glBindFramebuffer(GL_FRAMEBUFFER, target);
+		Shader &shader = shaders.deferred.Get(litFeatures());
+		shader.use();
+		setLitSamplers(shader);
+		// the whole screen, the lights are culled per pixel by the clusters if at all
+		DrawLights lights;
+		lightManager.BlockLights(lights);
+		setDrawLights(shader, lights);
+		shader.setInt("gAlbedoShininess", GBufferAlbedoUnit - GL_TEXTURE0);
+		shader.setInt("gNormal", GBufferNormalUnit - GL_TEXTURE0);
+		shader.setInt("gDepth", GBufferDepthUnit - GL_TEXTURE0);
+		glActiveTexture(GBufferAlbedoUnit);
+		glBindTexture(GL_TEXTURE_2D, gAlbedoShininess);
+		glActiveTexture(GBufferNormalUnit);
+		glBindTexture(GL_TEXTURE_2D, gNormal);
+		glActiveTexture(GBufferDepthUnit);
+		glBindTexture(GL_TEXTURE_2D, gDepth);
+		glActiveTexture(DefaultTextureUnit);
+
+		// the pass writes the G-buffer's depth, which the depth test only allows when enabled
+		glDepthFunc(GL_ALWAYS);
+		glDisable(GL_CULL_FACE);
+		glBindVertexArray(quadVAO);
+		glDrawArrays(GL_TRIANGLES, 0, 6);
+		glEnable(GL_CULL_FACE);
+		glDepthFunc(GL_LESS);
+	}
+}
+
+// draws every object of the scene with the lit shaders into target, which is bound and cleared
+void drawScene(SceneShaders &shaders, unsigned int target)
+{
+	if (deferredShading)
+		drawDeferred(shaders, target);
+
+	{ ScopedPass pass("drawCubes");		drawCubes(shaders.reflect); }
+	if (!deferredShading) {
+		ScopedPass pass("drawFloor");
+		drawFloor(shaders.lighting.Get(litFeatures()));
+	}
+	{ ScopedPass pass("drawLightCube");	drawLightCube(shaders.lightCube); }
+	if (!deferredShading) {
+		ScopedPass pass("drawModels");
+		drawModels(shaders.model.Get(litFeatures()));
+	}
+	{ ScopedPass pass("drawGrasses");	drawGrasses(shaders.blending); }
+	{ ScopedPass pass("drawWindows");	drawWindows(shaders.blending); }
+	{ ScopedPass pass("drawSkybox");	drawSkybox(shaders.skybox); }
+}
+
+void updateLights()
+{
+	PROFILE_FUNCTION();
+
+	// spin light sources
+	// blue
+	pointLightPositions[0].x = 1.0f + cos(sceneTime) * 3.0f;
+	pointLightPositions[0].y = 5.0f + cos(sceneTime) * 3.0f;
+	pointLightPositions[0].z = -15.0f + sin(sceneTime) * 3.0f;
+	// green				   
+	pointLightPositions[1].x = 1.0f - cos(sceneTime) * 3.0f;
+	pointLightPositions[1].y = 5.0f - cos(sceneTime) * 3.0f;
+	pointLightPositions[1].z = -15.0f - sin(sceneTime) * 3.0f;
+	// yellow						   
+	pointLightPositions[2].x = 1.0f - sin(sceneTime) * 2.0f;
+	pointLightPositions[2].y = 5.0f - cos(sceneTime) * 2.0f;
+	pointLightPositions[2].z = -15.0f - cos(sceneTime) * 2.0f;
+	// red						   
+	pointLightPositions[3].x = 1.0f + sin(sceneTime) * 2.0f;
+	pointLightPositions[3].y = 5.0f + cos(sceneTime) * 2.0f;
+	pointLightPositions[3].z = -15.0f + cos(sceneTime) * 2.0f;
+
+	for (unsigned int i = 0; i < NR_POINT_LIGHTS; ++i) {
+		lightManager.SetPosition(i, pointLightPositions[i]);
+		lightManager.SetColor(i, lightColors[i]);
+	}
+
+	// the spot light is the camera's flashlight
+	lightManager.SetPosition(flashlight, camera.Position);
+	lightManager.SetDirection(flashlight, camera.Front);
+
+	// only the uniform block path is limited to the scene's own lights
+	unsigned int lightCount = sceneLightCount + (unsigned int)glm::max(extraLights, 0);
+	if (lightManager.Count() > lightCount)
+		lightManager.Truncate(lightCount);
+	while (lightManager.Count() < lightCount)
+		addExtraLight(lightManager.Count() - sceneLightCount);
+
+	lightManager.Upload();
+}
+
+void addExtraLight(unsigned int index)
+{
+	// same light for the same index on every run, so benchmarks stay comparable
+	unsigned int seed = index * 2654435761u + 1013904223u;
+	float random[6];
+	for (unsigned int i = 0; i < 6; i++) {
+		seed = seed * 1664525u + 1013904223u;
+		random[i] = (seed >> 8) / 16777216.0f;
+	}
+
+	// the floor spans x -35..65 and z -50..50 at a height of about 1
+	glm::vec3 position(-35.0f + random[0] * 100.0f, 1.5f + random[1] * 3.0f, -50.0f + random[2] * 100.0f);
+	glm::vec3 color = glm::normalize(glm::vec3(random[3], random[4], random[5]) + glm::vec3(0.1f));
+	lightManager.AddPointLight(PointLight(color, glm::vec3(0.0f), glm::vec3(0.8f), glm::vec3(0.5f), position, 1.0f, 0.7f, 1.8f));
+}
+
+void updateFrameUniforms()
+{
+	PROFILE_FUNCTION();
+
+	projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, cameraNear, cameraFar);
+	view = camera.GetViewMatrix();
+	// reallocates the shadow maps only when the settings changed
+	shadowCascades.Configure((unsigned int)shadowCascadeCount, (unsigned int)std::max(shadowMapSize, 0));
+	shadowCascades.Update(view, glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, cameraNear, glm::min(shadowDistance, cameraFar), -lightPos);
+
+	frameUniforms.Update(projection, view, shadowCascades, camera.Position, ClusteredLights::ShaderParams(SCR_WIDTH, SCR_HEIGHT, cameraNear, cameraFar));
+}
+
+void invalidateMovedCasters()
+{
+	const glm::vec3 transforms[STATIC_CASTER_TRANSFORMS] = { MTranslate, FTranslate, FRotateAxis, HRotateAxis, HTranslate, ORotateAxis, OTranslate, glm::vec3(FRotate, HRotateAngle, ORotateAngle) };
+	if (std::equal(transforms, transforms + STATIC_CASTER_TRANSFORMS, cachedCasterTransforms))
+		return;
+	std::copy(transforms, transforms + STATIC_CASTER_TRANSFORMS, cachedCasterTransforms);
+	shadowCascades.InvalidateCache();
+	pointShadows.Invalidate();
+}
+
+void drawShadowCasters(Shader &shader, bool dynamic)
+{
+	for (unsigned int i = 0; i < SCENE_OBJECT_COUNT; i++) {
+		const SceneObject &object = sceneObjects[i];
+		if (!(object.passes & ShadowCasterPass) || ((object.passes & DynamicObject) != 0) != dynamic)
+			continue;
+		ScopedPass pass(object.name);
+		shader.use();
+		object.draw(shader);
+	}
+}
+
+// draws the shadow casters that are dynamic or not into the layer of the cascade, skipping every
+// instance outside its light frustum
+void drawCascadeCasters(SceneShaders &shaders, unsigned int cascade, bool dynamic)
+{
+	shadowCullMatrix = &shadowCascades.Matrices()[cascade];
+	shaders.depth.use();
+	shaders.depth.setInt("cascade", cascade);
+	drawShadowCasters(shaders.depth, dynamic);
+	shadowCullMatrix = nullptr;
+}
+
+float pointShadowImportance(const glm::vec3 &position, float range)
+{
+	// radius of the light's range on screen in pixels, every texel of a face then covers about
+	// a pixel where the range is in view
+	glm::vec3 toLight = position - camera.Position;
+	float distance2 = glm::dot(toLight, toLight);
+	if (distance2 <= range * range)
+		return (float)pointShadowSize;
+	float pixelsPerUnit = SCR_HEIGHT * 0.5f / std::tan(glm::radians(camera.Zoom) * 0.5f);
+	return range / std::sqrt(distance2 - range * range) * pixelsPerUnit;
+}
+
+void renderPointShadows(SceneShaders &shaders)
+{
+	PROFILE_FUNCTION();
+
+	shadowAtlas.Configure((unsigned int)std::max(shadowAtlasSize, 0));
+	pointShadows.Configure(pointLightShadows ? PointShadows::MAX_LIGHTS : 0, (unsigned int)pointShadowSize, shadowAtlas);
+	for (unsigned int i = 0; i < pointShadows.Count(); i++) {
+		int light = lightManager.BlockPointLight(i);
+		if (light >= 0)
+			pointShadows.SetLight(i, lightManager.Positions()[light], lightManager.Ranges()[light], pointShadowImportance(lightManager.Positions()[light], lightManager.Ranges()[light]));
+	}
+	pointShadows.AllocateTiles();
+	if (pointShadows.Schedule((unsigned int)pointShadowFaceBudget) == 0)
+		return;
+
+	static const char* lightPasses[PointShadows::MAX_LIGHTS] = { "pointLight0", "pointLight1", "pointLight2", "pointLight3" };
+	Shader &shader = shaders.pointDepth;
+	shader.use();
+	// initialize if necessary
+	static unsigned int resolvedProgram = 0;
+	static UniformHandle shadowMatrices[PointShadows::FACES], shadowTiles[PointShadows::FACES], lightPosition, farPlane;
+	if (resolvedProgram != shader.ID) {
+		for (unsigned int face = 0; face < PointShadows::FACES; face++) {
+			shadowMatrices[face] = shader.getUniform("shadowMatrices[" + std::to_string(face) + "]");
+			shadowTiles[face] = shader.getUniform("shadowTiles[" + std::to_string(face) + "]");
+		}
+		lightPosition = shader.getUniform("lightPosition");
+		farPlane = shader.getUniform("farPlane");
+		resolvedProgram = shader.ID;
+	}
+	// the geometry shader clips every face to its tile
+	for (unsigned int plane = 0; plane < 4; plane++)
+		glEnable(GL_CLIP_DISTANCE0 + plane);
+	for (unsigned int i = 0; i < pointShadows.Count(); i++) {
+		if (pointShadows.ScheduledFaces(i) == 0)
+			continue;
+		ScopedPass pass(lightPasses[i]);
+		pointShadows.BeginLight(i);
+		for (unsigned int face = 0; face < PointShadows::FACES; face++) {
+			shader.setMat4(shadowMatrices[face], pointShadows.FaceMatrices(i)[face]);
+			shader.setVec4(shadowTiles[face], pointShadows.TileRect(i, face));
+		}
+		shader.setVec3(lightPosition, pointShadows.Position(i));
+		shader.setFloat(farPlane, pointShadows.FarPlane(i));
+		// the light cubes sit around the lights, so only the static casters are drawn
+		pointShadowCullLight = (int)i;
+		drawShadowCasters(shader, false);
+		pointShadowCullLight = -1;
+	}
+	for (unsigned int plane = 0; plane < 4; plane++)
+		glDisable(GL_CLIP_DISTANCE0 + plane);
+}
+
+void renderShadowMoments(SceneShaders &shaders)
+{
+	PROFILE_FUNCTION();
+
+	shadowMoments.Configure(shadowCascades.Count(), shadowCascades.Resolution());
+	float texelSize = 1.0f / shadowMoments.Resolution();
+
+	glDisable(GL_DEPTH_TEST);
+	glDisable(GL_CULL_FACE);
+	glBindVertexArray(quadVAO);
+	glActiveTexture(DefaultTextureUnit);
+	shaders.momentsFromDepth.use();
+	shaders.momentsFromDepth.setInt("source", 0);
+	shaders.momentsFromDepth.setVec2("texelStep", texelSize, 0.0f);
+	shaders.momentsFromDepth.setInt("radius", shadowMoments.BlurRadius);
+	shaders.momentsBlur.use();
+	shaders.momentsBlur.setInt("source", 0);
+	shaders.momentsBlur.setInt("layer", 0);
+	shaders.momentsBlur.setVec2("texelStep", 0.0f, texelSize);
+	shaders.momentsBlur.setInt("radius", shadowMoments.BlurRadius);
+
+	for (unsigned int c = 0; c < shadowCascades.Count(); c++) {
+		shadowMoments.BeginBlur(c, false);
+		shaders.momentsFromDepth.use();
+		shaders.momentsFromDepth.setInt("layer", (int)c);
+		// the depth without the compare of the lit shaders
+		glBindSampler(0, shadowMoments.DepthSampler());
+		glBindTexture(GL_TEXTURE_2D_ARRAY, shadowCascades.DepthTexture());
+		glDrawArrays(GL_TRIANGLES, 0, 6);
+
+		shadowMoments.BeginBlur(c, true);
+		shaders.momentsBlur.use();
+		glBindSampler(0, 0);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, shadowMoments.BlurTexture());
+		glDrawArrays(GL_TRIANGLES, 0, 6);
+	}
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	glEnable(GL_CULL_FACE);
+	glEnable(GL_DEPTH_TEST);
+
+	shadowMoments.GenerateMipmaps();
+}
+
+bool shadowCulled(Shader &shader, const glm::mat4 &model, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax)
+{
+	if (shadowCullMatrix != nullptr) {
+		// the light projections are orthographic, so the box stays a parallelepiped in clip space
+		// and its center and extent along each clip axis decide the test
+		glm::mat4 clip = *shadowCullMatrix * model;
+		glm::vec3 center = glm::vec3(clip * glm::vec4((boundsMin + boundsMax) * 0.5f, 1.0f));
+		glm::vec3 extent = (boundsMax - boundsMin) * 0.5f;
+		glm::mat3 axes = glm::mat3(clip);
+		glm::vec3 clipExtent = glm::abs(axes[0]) * extent.x + glm::abs(axes[1]) * extent.y + glm::abs(axes[2]) * extent.z;
+		return glm::any(glm::greaterThan(glm::abs(center) - clipExtent, glm::vec3(1.0f)));
+	}
+
+	if (pointShadowCullLight >= 0) {
+		glm::vec3 worldMin, worldMax;
+		transformBounds(model, boundsMin, boundsMax, worldMin, worldMax);
+		unsigned int faces = pointShadows.FaceMask((unsigned int)pointShadowCullLight, worldMin, worldMax);
+		if (faces == 0)
+			return true;
+		shader.setInt("faceMask", (int)faces);
+	}
+	return false;
+}
+
+void updateClusters()
+{
+	if (!clusteredShading)
+		return;
+
+	clusteredLights.Update(lightManager, view, projection, cameraNear, cameraFar);
+
+	// bound for the whole frame, no other pass uses these units
+	glActiveTexture(ClusterLightDataUnit);
+	glBindTexture(GL_TEXTURE_BUFFER, lightManager.LightTexture());
+	clusteredLights.Bind(ClusterGridUnit, ClusterIndexUnit);
+	glActiveTexture(DefaultTextureUnit);
+}
+
+void renderScene(SceneShaders &shaders)
+{
+	PROFILE_FUNCTION();
+
+	updateLights();
+	updateFrameUniforms();
+	updateClusters();
+
+	// apply post processing effects
+	glEnable(GL_DEPTH_TEST);
+	if (activeKernel != DISABLED) {
+		ScopedPass pass("vfx");
+		PROFILE_ZONE("vfx");
+		glActiveTexture(DefaultTextureUnit);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer); // bind custom framebuffer before rendering for vfx
+		glClearColor(clearColor.x, clearColor.y, clearColor.z, clearColor.w);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		drawScene(shaders, framebuffer);
+	}
+
+	// first pass: render scene from light's point of view
+	// ---------------------------------------------------
+	if (shadows) {
+		ScopedPass pass("shadow");
+		PROFILE_ZONE("shadow");
+		invalidateMovedCasters();
+		static const char* cascadePasses[ShadowCascades::MAX_CASCADES] = { "cascade0", "cascade1", "cascade2", "cascade3" };
+		for (unsigned int c = 0; c < shadowCascades.Count(); c++) {
+			ScopedPass pass(cascadePasses[c]);
+			if (shadowCache) {
+				if (shadowCascades.BeginStaticCascade(c)) {
+					ScopedPass pass("staticCasters");
+					drawCascadeCasters(shaders, c, false);
+				}
+				shadowCascades.BeginCachedCascade(c);
+			} else {
+				shadowCascades.BeginCascade(c);
+				drawCascadeCasters(shaders, c, false);
+			}
+			drawCascadeCasters(shaders, c, true);
+		}
+		glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
+	}
+
+	// point light shadows, the faces left over by the budget keep last frame's depth
+	if (litFeatures().pointShadows) {
+		ScopedPass pass("pointShadows");
+		PROFILE_ZONE("pointShadows");
+		renderPointShadows(shaders);
+		glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
+	}
+
+	// the EVSM filter reads the cascades through their blurred moments
+	if (shadows && litFeatures().shadowFilter == ShadowFilterEvsm) {
+		ScopedPass pass("shadowMoments");
+		PROFILE_ZONE("shadowMoments");
+		renderShadowMoments(shaders);
+		glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
+	}
+
+	// second pass: render scene as normal using generated shadow map
+	// --------------------------------------------------------------
+	{
+		ScopedPass pass("lit");
+		PROFILE_ZONE("lit");
+		// the shadow passes may all be skipped, so don't count on them leaving the target bound
+		glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
+		glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
+		glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		// the lit shaders pick their cascade with the matrices and splits of the frame block
+		glActiveTexture(ShadowMapUnit);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, shadowCascades.DepthTexture());
+		glActiveTexture(ShadowMomentsUnit);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, shadowMoments.MomentsTexture());
+		glActiveTexture(ShadowAtlasUnit);
+		glBindTexture(GL_TEXTURE_2D, shadowAtlas.DepthTexture());
+		glActiveTexture(DefaultTextureUnit);
+		drawScene(shaders, sceneFBO);
+	}
+
+// 	shaders.debugDepthQuad.use();
+// 	glActiveTexture(DefaultTextureUnit);
+// 	glBindTexture(GL_TEXTURE_2D, depthMap);
+// 	renderQuad();
+
+	// draw a quad plane with the attached framebuffer color texture
+	if (activeKernel != DISABLED) {
+		ScopedPass pass("postprocess");
+		PROFILE_ZONE("postprocess");
+		glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
+		glDisable(GL_DEPTH_TEST);
+		glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		shaders.framebuffer.use();
+		shaders.framebuffer.setInt("screenTexture", 0);
+		shaders.framebuffer.setInt("activeKernel", activeKernel);
+		glBindVertexArray(quadVAO);
+		glActiveTexture(DefaultTextureUnit);
+		glBindTexture(GL_TEXTURE_2D, textureColorbuffer);
+		glDrawArrays(GL_TRIANGLES, 0, 6);
+	}
+}
+
+void vfxFramebuffer()
+{
+	if (quadVAO == 0) {
+		float quadVertices[] = { // vertex attributes for a quad that fills the entire screen in Normalized Device Coordinates.
+			// positions   // texCoords
+			-1.0f,  1.0f,  0.0f, 1.0f,
+			-1.0f, -1.0f,  0.0f, 0.0f,
+			 1.0f, -1.0f,  1.0f, 0.0f,
+
+			-1.0f,  1.0f,  0.0f, 1.0f,
+			 1.0f, -1.0f,  1.0f, 0.0f,
+			 1.0f,  1.0f,  1.0f, 1.0f
+		};
+		
+			// screen quad VAO		
+			glGenVertexArrays(1, &quadVAO);
+			glGenBuffers(1, &quadVBO);
+			glBindVertexArray(quadVAO);
+			glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+			glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
+			glEnableVertexAttribArray(0);
+			glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), nullptr);
+			glEnableVertexAttribArray(1);
+			glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+
+			// framebuffer configuration		
+			glGenFramebuffers(1, &framebuffer);
+			glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+			// create a color attachment texture		
+			glGenTextures(1, &textureColorbuffer);
+			glActiveTexture(DefaultTextureUnit);
+			glBindTexture(GL_TEXTURE_2D, textureColorbuffer);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, SCR_WIDTH, SCR_HEIGHT, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureColorbuffer, 0);
+			// create a renderbuffer object for depth and stencil attachment
+			unsigned int rbo;
+			glGenRenderbuffers(1, &rbo);
+			glBindRenderbuffer(GL_RENDERBUFFER, rbo);
+			glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, SCR_WIDTH, SCR_HEIGHT);
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, rbo);
+			if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+				std::cout << "Error::Framebuffer: Framebuffer is not complete." << std::endl;
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		
+	}
+}
+
+void gbufferFramebuffer()
+{
+	if (gbufferFBO != 0)
+		return;
+
+	glGenFramebuffers(1, &gbufferFBO);
+	glBindFramebuffer(GL_FRAMEBUFFER, gbufferFBO);
+	// albedo and shininess, octahedral normal and blinn scale, see Shaders/include/gbuffer.glsl
+	glGenTextures(1, &gAlbedoShininess);
+	glActiveTexture(GBufferAlbedoUnit);
+	glBindTexture(GL_TEXTURE_2D, gAlbedoShininess);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, SCR_WIDTH, SCR_HEIGHT, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, gAlbedoShininess, 0);
+	glGenTextures(1, &gNormal);
+	glActiveTexture(GBufferNormalUnit);
+	glBindTexture(GL_TEXTURE_2D, gNormal);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB10_A2, SCR_WIDTH, SCR_HEIGHT, 0, GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, gNormal, 0);
+	// the position is reconstructed from depth, so it is a texture instead of a renderbuffer
+	glGenTextures(1, &gDepth);
+	glActiveTexture(GBufferDepthUnit);
+	glBindTexture(GL_TEXTURE_2D, gDepth);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, SCR_WIDTH, SCR_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, gDepth, 0);
+	GLenum attachments[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+	glDrawBuffers(2, attachments);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "Error::Framebuffer: G-buffer is not complete." << std::endl;
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glActiveTexture(DefaultTextureUnit);
+}
+
+unsigned int loadTexture(char const * path)
+{
+	unsigned int textureID;
+	glGenTextures(1, &textureID);
+
+	int width, height, nrComponents;
+	unsigned char *data = stbi_load(path, &width, &height, &nrComponents, 0);
+	if (data) {
+		GLenum format;
+		if (nrComponents == 1)
+			format = GL_RED;
+		else if (nrComponents == 3)
+			format = GL_RGB;
+		else if (nrComponents == 4)
+			format = GL_RGBA;
+
+		glActiveTexture(DefaultTextureUnit);
+		glBindTexture(GL_TEXTURE_2D, textureID);
+		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+		glGenerateMipmap(GL_TEXTURE_2D);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, format == GL_RGBA ? GL_CLAMP_TO_EDGE : GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, format == GL_RGBA ? GL_CLAMP_TO_EDGE : GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		stbi_image_free(data);
+	} else {
+		std::cout << "Texture failed to load at path: " << path << std::endl;
+		stbi_image_free(data);
+	}
+
+	return textureID;
+}
+
+unsigned int loadCubemap(std::vector<std::string> faces)
+{
+	unsigned int textureID;
+	glGenTextures(1, &textureID);
+	glActiveTexture(DefaultTextureUnit);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+
+	int width, height, nrChannels;
+	for (size_t i = 0; i < faces.size(); i++) {
+		unsigned char* data = stbi_load(faces[i].c_str(), &width, &height, &nrChannels, 0);
+		if (data) {
+			glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+			stbi_image_free(data);
+		} else {
+			std::cout << "Cubemap texture failed to load at path: " << faces[i] << std::endl;
+			stbi_image_free(data);
+		}
+	}
+
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+	return textureID;
+}
+
+unsigned int cubeVAO = 0, cubeVBO = 0;
+void drawCubes(Shader &shader)
+{
+	PROFILE_FUNCTION();
+
+	// initialize if necessary	
+	if (cubeVAO == 0) {
+		float vertices[] = {
+			// positions		   // Normals				// texCoord
+		   -0.5f, -0.5f, -0.5f,	   0.0f,  0.0f, -1.0f,    0.0f, 0.0f,
+			0.5f,  0.5f, -0.5f,	   0.0f,  0.0f, -1.0f,    1.0f, 1.0f,
+			0.5f, -0.5f, -0.5f,	   0.0f,  0.0f, -1.0f,    1.0f, 0.0f,
+			0.5f,  0.5f, -0.5f,	   0.0f,  0.0f, -1.0f,    1.0f, 1.0f,
+		   -0.5f, -0.5f, -0.5f,	   0.0f,  0.0f, -1.0f,    0.0f, 0.0f,
+		   -0.5f,  0.5f, -0.5f,	   0.0f,  0.0f, -1.0f,    0.0f, 1.0f,
+
+		   -0.5f, -0.5f,  0.5f,	   0.0f,  0.0f,  1.0f,    0.0f, 0.0f,
+			0.5f, -0.5f,  0.5f,	   0.0f,  0.0f,  1.0f,    1.0f, 0.0f,
+			0.5f,  0.5f,  0.5f,	   0.0f,  0.0f,  1.0f,    1.0f, 1.0f,
+			0.5f,  0.5f,  0.5f,	   0.0f,  0.0f,  1.0f,    1.0f, 1.0f,
+		   -0.5f,  0.5f,  0.5f,	   0.0f,  0.0f,  1.0f,    0.0f, 1.0f,
+		   -0.5f, -0.5f,  0.5f,	   0.0f,  0.0f,  1.0f,    0.0f, 0.0f,
+
+		   -0.5f,  0.5f,  0.5f,	  -1.0f,  0.0f,  0.0f,    1.0f, 0.0f,
+		   -0.5f,  0.5f, -0.5f,	  -1.0f,  0.0f,  0.0f,    1.0f, 1.0f,
+		   -0.5f, -0.5f, -0.5f,	  -1.0f,  0.0f,  0.0f,    0.0f, 1.0f,
+		   -0.5f, -0.5f, -0.5f,	  -1.0f,  0.0f,  0.0f,    0.0f, 1.0f,
+		   -0.5f, -0.5f,  0.5f,	  -1.0f,  0.0f,  0.0f,    0.0f, 0.0f,
+		   -0.5f,  0.5f,  0.5f,	  -1.0f,  0.0f,  0.0f,    1.0f, 0.0f,
+
+			0.5f,  0.5f,  0.5f,	   1.0f,  0.0f,  0.0f,    1.0f, 0.0f,
+			0.5f, -0.5f, -0.5f,	   1.0f,  0.0f,  0.0f,    0.0f, 1.0f,
+			0.5f,  0.5f, -0.5f,	   1.0f,  0.0f,  0.0f,    1.0f, 1.0f,
+			0.5f, -0.5f, -0.5f,	   1.0f,  0.0f,  0.0f,    0.0f, 1.0f,
+			0.5f,  0.5f,  0.5f,	   1.0f,  0.0f,  0.0f,    1.0f, 0.0f,
+			0.5f, -0.5f,  0.5f,	   1.0f,  0.0f,  0.0f,    0.0f, 0.0f,
+
+		   -0.5f, -0.5f, -0.5f,	   0.0f, -1.0f,  0.0f,    0.0f, 1.0f,
+			0.5f, -0.5f, -0.5f,	   0.0f, -1.0f,  0.0f,    1.0f, 1.0f,
+			0.5f, -0.5f,  0.5f,	   0.0f, -1.0f,  0.0f,    1.0f, 0.0f,
+			0.5f, -0.5f,  0.5f,	   0.0f, -1.0f,  0.0f,    1.0f, 0.0f,
+		   -0.5f, -0.5f,  0.5f,	   0.0f, -1.0f,  0.0f,    0.0f, 0.0f,
+		   -0.5f, -0.5f, -0.5f,	   0.0f, -1.0f,  0.0f,    0.0f, 1.0f,
+
+		   -0.5f,  0.5f, -0.5f,	   0.0f,  1.0f,  0.0f,    0.0f, 1.0f,
+			0.5f,  0.5f,  0.5f,	   0.0f,  1.0f,  0.0f,    1.0f, 0.0f,
+			0.5f,  0.5f, -0.5f,	   0.0f,  1.0f,  0.0f,    1.0f, 1.0f,
+			0.5f,  0.5f,  0.5f,	   0.0f,  1.0f,  0.0f,    1.0f, 0.0f,
+		   -0.5f,  0.5f, -0.5f,	   0.0f,  1.0f,  0.0f,    0.0f, 1.0f,
+		   -0.5f,  0.5f,  0.5f,	   0.0f,  1.0f,  0.0f,    0.0f, 0.0f
+		};
+
+		glGenVertexArrays(1, &cubeVAO);
+		glGenBuffers(1, &cubeVBO);
+
+		// bind VAO first then bind VBO and configure vertex attributes
+		glBindVertexArray(cubeVAO);
+
+		glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+		// position attributes
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), nullptr);
+
+		// normal coord attributes
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+
+		// texture coord attributes
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+
+		//unbind VBO and VAO
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+	}
+
+	// draw reflective cube
+	shader.use();
+	glm::mat4 model = glm::mat4(1.0f);
+	model = glm::scale(model, glm::vec3(0.1f, 10.0f, 10.0f));
+	model = glm::translate(model, MTranslate);
+	if (shadowCulled(shader, model, glm::vec3(-0.5f), glm::vec3(0.5f)))
+		return;
+	shader.setMat4("model", model);
+
+	glBindVertexArray(cubeVAO);
+	glDrawArrays(GL_TRIANGLES, 0, 36);
+
+	// draw refractive cube
+// 	shader.use();
+// 	model = glm::mat4(1.0f);
+// 	model = glm::scale(model, glm::vec3(0.1f, 10.0f, 10.0f));
+// 	model = glm::translate(model, RTranslate);
+// 	shader.setMat4("model", model);
+
+	glBindVertexArray(cubeVAO);
+	glDrawArrays(GL_TRIANGLES, 0, 36);
+}
+
+unsigned int floorVAO = 0, floorVBO = 0, floorTex = 0;
+void drawFloor(Shader &shader)
+{
+	PROFILE_FUNCTION();
+
+	// initialize if necessary
+	if(floorVAO == 0) {
+		floorTex = loadTexture("Resources/wood.png");
+
+		shader.use();
+		shader.setInt("floor", 0);
+
+		// set up floor vertices
+		float floorVertices[] = {
+			 -10.0f, -10.0f, -10.0f,    0.0f,  0.0f, -1.0f,    0.0f, 0.0f,
+			  10.0f, -10.0f, -10.0f,    0.0f,  0.0f, -1.0f,    10.0f, 0.0f,
+			  10.0f,  10.0f, -10.0f,    0.0f,  0.0f, -1.0f,    10.0f, 10.0f,
+			  10.0f,  10.0f, -10.0f,    0.0f,  0.0f, -1.0f,    10.0f, 10.0f,
+			 -10.0f,  10.0f, -10.0f,    0.0f,  0.0f, -1.0f,    0.0f, 10.0f,
+			 -10.0f, -10.0f, -10.0f,    0.0f,  0.0f, -1.0f,    0.0f, 0.0f
+		};
+
+		glGenVertexArrays(1, &floorVAO);
+		glGenBuffers(1, &floorVBO);
+
+		// bind VAO first then bind VBO and configure vertex attributes
+		glBindVertexArray(floorVAO);
+
+		glBindBuffer(GL_ARRAY_BUFFER, floorVBO);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(floorVertices), floorVertices, GL_STATIC_DRAW);
+
+		// position attributes
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), nullptr);
+
+		// normal coord attributes
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+
+		// texture coord attributes
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+
+		//unbind VBO and VAO
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+	}
+
+	glm::mat4 model = glm::mat4(1.0f);
+	model = glm::translate(model, FTranslate);
+	model = glm::rotate(model, glm::radians(FRotate), FRotateAxis);
+	model = glm::scale(model, glm::vec3(5.0f));
+	if (shadowCulled(shader, model, glm::vec3(-10.0f, -10.0f, -10.0f), glm::vec3(10.0f, 10.0f, -10.0f)))
+		return;
+
+	glDisable(GL_CULL_FACE);
+	glBindTexture(GL_TEXTURE_2D, floorTex);
+	shader.use();
+
+	// set floor uniforms
+	setLitSamplers(shader);
+	Material shinyMaterial = Material(shader);
+	shinyMaterial.UseMaterial(4.0f, 32);
+
+	// draw floor
+	glBindVertexArray(floorVAO);
+	shader.setMat4("model", model);
+	if (shader.getUniform("drawPointLightCount").valid()) {
+		DrawLights lights;
+		lightManager.BlockLights(lights);
+		setDrawLights(shader, lights, model, glm::vec3(-10.0f, -10.0f, -10.0f), glm::vec3(10.0f, 10.0f, -10.0f), lights);
+	}
+	glDrawArrays(GL_TRIANGLES, 0, 6);
+	glEnable(GL_CULL_FACE);
+}
+
+unsigned int lightCubeVAO = 0, lightCubeVBO = 0;
+void drawLightCube(Shader &shader)
+{
+	PROFILE_FUNCTION();
+
+	// initialize if necessary
+	if(lightCubeVAO == 0)
+	{
+		float vertices[] = {
+			// positions		   // Normals				// texCoord
+		   -0.5f, -0.5f, -0.5f,	   0.0f,  0.0f, -1.0f,    0.0f, 0.0f,
+			0.5f,  0.5f, -0.5f,	   0.0f,  0.0f, -1.0f,    1.0f, 1.0f,
+			0.5f, -0.5f, -0.5f,	   0.0f,  0.0f, -1.0f,    1.0f, 0.0f,
+			0.5f,  0.5f, -0.5f,	   0.0f,  0.0f, -1.0f,    1.0f, 1.0f,
+		   -0.5f, -0.5f, -0.5f,	   0.0f,  0.0f, -1.0f,    0.0f, 0.0f,
+		   -0.5f,  0.5f, -0.5f,	   0.0f,  0.0f, -1.0f,    0.0f, 1.0f,
+
+		   -0.5f, -0.5f,  0.5f,	   0.0f,  0.0f,  1.0f,    0.0f, 0.0f,
+			0.5f, -0.5f,  0.5f,	   0.0f,  0.0f,  1.0f,    1.0f, 0.0f,
+			0.5f,  0.5f,  0.5f,	   0.0f,  0.0f,  1.0f,    1.0f, 1.0f,
+			0.5f,  0.5f,  0.5f,	   0.0f,  0.0f,  1.0f,    1.0f, 1.0f,
+		   -0.5f,  0.5f,  0.5f,	   0.0f,  0.0f,  1.0f,    0.0f, 1.0f,
+		   -0.5f, -0.5f,  0.5f,	   0.0f,  0.0f,  1.0f,    0.0f, 0.0f,
+
+		   -0.5f,  0.5f,  0.5f,	  -1.0f,  0.0f,  0.0f,    1.0f, 0.0f,
+		   -0.5f,  0.5f, -0.5f,	  -1.0f,  0.0f,  0.0f,    1.0f, 1.0f,
+		   -0.5f, -0.5f, -0.5f,	  -1.0f,  0.0f,  0.0f,    0.0f, 1.0f,
+		   -0.5f, -0.5f, -0.5f,	  -1.0f,  0.0f,  0.0f,    0.0f, 1.0f,
+		   -0.5f, -0.5f,  0.5f,	  -1.0f,  0.0f,  0.0f,    0.0f, 0.0f,
+		   -0.5f,  0.5f,  0.5f,	  -1.0f,  0.0f,  0.0f,    1.0f, 0.0f,
+
+			0.5f,  0.5f,  0.5f,	   1.0f,  0.0f,  0.0f,    1.0f, 0.0f,
+			0.5f, -0.5f, -0.5f,	   1.0f,  0.0f,  0.0f,    0.0f, 1.0f,
+			0.5f,  0.5f, -0.5f,	   1.0f,  0.0f,  0.0f,    1.0f, 1.0f,
+			0.5f, -0.5f, -0.5f,	   1.0f,  0.0f,  0.0f,    0.0f, 1.0f,
+			0.5f,  0.5f,  0.5f,	   1.0f,  0.0f,  0.0f,    1.0f, 0.0f,
+			0.5f, -0.5f,  0.5f,	   1.0f,  0.0f,  0.0f,    0.0f, 0.0f,
+
+		   -0.5f, -0.5f, -0.5f,	   0.0f, -1.0f,  0.0f,    0.0f, 1.0f,
+			0.5f, -0.5f, -0.5f,	   0.0f, -1.0f,  0.0f,    1.0f, 1.0f,
+			0.5f, -0.5f,  0.5f,	   0.0f, -1.0f,  0.0f,    1.0f, 0.0f,
+			0.5f, -0.5f,  0.5f,	   0.0f, -1.0f,  0.0f,    1.0f, 0.0f,
+		   -0.5f, -0.5f,  0.5f,	   0.0f, -1.0f,  0.0f,    0.0f, 0.0f,
+		   -0.5f, -0.5f, -0.5f,	   0.0f, -1.0f,  0.0f,    0.0f, 1.0f,
+
+		   -0.5f,  0.5f, -0.5f,	   0.0f,  1.0f,  0.0f,    0.0f, 1.0f,
+			0.5f,  0.5f,  0.5f,	   0.0f,  1.0f,  0.0f,    1.0f, 0.0f,
+			0.5f,  0.5f, -0.5f,	   0.0f,  1.0f,  0.0f,    1.0f, 1.0f,
+			0.5f,  0.5f,  0.5f,	   0.0f,  1.0f,  0.0f,    1.0f, 0.0f,
+		   -0.5f,  0.5f, -0.5f,	   0.0f,  1.0f,  0.0f,    0.0f, 1.0f,
+		   -0.5f,  0.5f,  0.5f,	   0.0f,  1.0f,  0.0f,    0.0f, 0.0f
+		};
+			
+		glGenVertexArrays(1, &lightCubeVAO);
+		glBindVertexArray(lightCubeVAO);
+		glGenBuffers(1, &lightCubeVBO);
+		glBindBuffer(GL_ARRAY_BUFFER, lightCubeVBO);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+		glBindBuffer(GL_ARRAY_BUFFER, lightCubeVBO);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);		
+	}
+
+	// draw the lamp object
+	// we now draw as many light bulbs as we have point lights.
+	glBindVertexArray(lightCubeVAO);
+	for (unsigned int i = 0; i < 4; i++) {
+		shader.use();
+		glm::mat4 model = glm::mat4(1.0f);
+		model = glm::translate(model, pointLightPositions[i]);
+		model = glm::scale(model, glm::vec3(0.2f)); // Make it a smaller cube
+		if (shadowCulled(shader, model, glm::vec3(-0.5f), glm::vec3(0.5f)))
+			continue;
+		shader.setMat4("model", model);
+		shader.setVec3("color", lightColors[i]);
+
+		glDrawArrays(GL_TRIANGLES, 0, 36);
+	}
+}
+
+void drawModels(Shader &shader)
+{
+	PROFILE_FUNCTION();
+
+	glEnable(GL_CULL_FACE);
+	glFrontFace(GL_CCW);
+	glCullFace(GL_BACK);
+	shader.use();
+
+	// set model uniforms
+// 	shader.setVec3("lightPos", lightPos);
+	setLitSamplers(shader);
+
+	// draw house
+	glm::mat4 model = glm::mat4(1.0f);
+	model = glm::rotate(model, glm::radians(HRotateAngle), HRotateAxis);
+	model = glm::translate(model, HTranslate);
+	shader.setMat4("model", model);
+	Material shinyMaterial = Material(shader);
+	shinyMaterial.UseMaterial(4.0f, 256);
+	drawLitModel(shader, house, model);
+
+	// draw ori
+	shader.use();
+	model = glm::mat4(1.0f);
+	model = glm::rotate(model, glm::radians(ORotateAngle), ORotateAxis);
+	model = glm::translate(model, OTranslate);
+	model = glm::scale(model, glm::vec3(0.5f));
+	shader.setMat4("model", model);
+	drawLitModel(shader, ori, model);
+}
+
+unsigned int grassVAO = 0, grassVBO = 0, grass = 0;
+void drawGrasses(Shader &shader)
+{
+	PROFILE_FUNCTION();
+
+	// initialize if necessary
+	if(grassVAO == 0)
+	{
+		grass = loadTexture("Resources/grass.png");
+		shader.use();
+		shader.setInt("texture1", 0);
+
+		// grass vertices
+		float transparentVertices[] = {
+			// positions         // texture Coords (swapped y coordinates because texture is flipped upside down)
+			0.0f,  0.5f,  0.0f,  0.0f,  0.0f,
+			0.0f, -0.5f,  0.0f,  0.0f,  1.0f,
+			1.0f, -0.5f,  0.0f,  1.0f,  1.0f,
+
+			0.0f,  0.5f,  0.0f,  0.0f,  0.0f,
+			1.0f, -0.5f,  0.0f,  1.0f,  1.0f,
+			1.0f,  0.5f,  0.0f,  1.0f,  0.0f
+		};
+		
+		glGenVertexArrays(1, &grassVAO);
+		glGenBuffers(1, &grassVBO);
+		glBindVertexArray(grassVAO);
+		glBindBuffer(GL_ARRAY_BUFFER, grassVBO);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(transparentVertices), transparentVertices, GL_STATIC_DRAW);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), nullptr);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+		glBindVertexArray(0);
+	}
+
+	// grass locations
+	std::vector<glm::vec3> vegetation
+	{
+		glm::vec3(0.00f, 1.58f, 11.09f),
+		glm::vec3(-6.03f, 1.58f, 13.47f),
+		glm::vec3(-2.80f, 1.58f, 14.27f),
+		glm::vec3(-3.61f, 1.58f, 10.30f),
+		glm::vec3(-0.80f, 1.58f, 15.85f)
+	};
+
+	shader.use();
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glDisable(GL_CULL_FACE);	
+	glBindVertexArray(grassVAO);
+	glBindTexture(GL_TEXTURE_2D, grass);
+
+	glm::mat4 model = glm::mat4(1.0f);
+	for (size_t i = 0; i < vegetation.size(); i++) {
+		shader.use();
+		model = glm::mat4(1.0f);
+		model = glm::translate(model, vegetation[i]);
+		shader.setMat4("model", model);
+		glDrawArrays(GL_TRIANGLES, 0, 6);
+	}
+
+	glEnable(GL_CULL_FACE);
+	glDisable(GL_BLEND);
+}
+
+unsigned int windowVAO = 0, windowVBO = 0, transparentWindow = 0;
+void drawWindows(Shader &shader)
+{
+	PROFILE_FUNCTION();
+
+	// initialize if necessary
+	if (windowVAO == 0) {
+		transparentWindow = loadTexture("Resources/window.png");
+		shader.use();
+		shader.setInt("texture1", 0);
+
+		// grass vertices
+		float transparentVertices[] = {
+			// positions         // texture Coords (swapped y coordinates because texture is flipped upside down)
+			0.0f,  0.5f,  0.0f,  0.0f,  0.0f,
+			0.0f, -0.5f,  0.0f,  0.0f,  1.0f,
+			1.0f, -0.5f,  0.0f,  1.0f,  1.0f,
+
+			0.0f,  0.5f,  0.0f,  0.0f,  0.0f,
+			1.0f, -0.5f,  0.0f,  1.0f,  1.0f,
+			1.0f,  0.5f,  0.0f,  1.0f,  0.0f
+		};
+
+		glGenVertexArrays(1, &windowVAO);
+		glGenBuffers(1, &windowVBO);
+		glBindVertexArray(windowVAO);
+		glBindBuffer(GL_ARRAY_BUFFER, windowVBO);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(transparentVertices), transparentVertices, GL_STATIC_DRAW);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), nullptr);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+		glBindVertexArray(0);
+	}
+
+	// window locations
+	std::vector<glm::vec3> windows
+	{
+		glm::vec3(-6.45f, 1.58f, 13.09f),
+		glm::vec3(-4.03f, 1.58f, 15.47f),
+		glm::vec3(-0.80f, 1.58f, 16.27f),
+		glm::vec3(-1.61f, 1.58f, 12.30f),
+		glm::vec3(-5.64f, 1.58f, 17.85f)
+	};
+
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glDisable(GL_CULL_FACE);
+	// sort the transparent windows before rendering
+	std::map<float, glm::vec3> sorted;
+	{
+		PROFILE_ZONE("drawWindows sort");
+		for (unsigned int i = 0; i < windows.size(); i++) {
+			float distance = glm::length(camera.Position - windows[i]);
+			sorted[distance] = windows[i];
+		}
+	}
+
+	shader.use();
+	glm::mat4 model = glm::mat4(1.0f);
+	shader.setMat4("model", model);
+	glBindVertexArray(windowVAO);
+	glBindTexture(GL_TEXTURE_2D, transparentWindow);
+	for (auto it = sorted.rbegin(); it != sorted.rend(); ++it) {
+		shader.use();
+		model = glm::mat4(1.0f);
+		model = glm::translate(model, it->second);
+		shader.setMat4("model", model);
+		glDrawArrays(GL_TRIANGLES, 0, 6);
+	}
+	glEnable(GL_CULL_FACE);
+	glDisable(GL_BLEND);
+}
+
+unsigned int skyboxVAO = 0, skyboxVBO = 0, cubemapTexture = 0;
+void drawSkybox(Shader &skyboxShader)
+{
+	PROFILE_FUNCTION();
+
+	// initialize if necessary
+	if(skyboxVAO == 0)
+	{
+		float skyboxVertices[] = {
+			// positions          
+			-1.0f,  1.0f, -1.0f,
+			-1.0f, -1.0f, -1.0f,
+			 1.0f, -1.0f, -1.0f,
+			 1.0f, -1.0f, -1.0f,
+			 1.0f,  1.0f, -1.0f,
+			-1.0f,  1.0f, -1.0f,
+
+			-1.0f, -1.0f,  1.0f,
+			-1.0f, -1.0f, -1.0f,
+			-1.0f,  1.0f, -1.0f,
+			-1.0f,  1.0f, -1.0f,
+			-1.0f,  1.0f,  1.0f,
+			-1.0f, -1.0f,  1.0f,
+
+			 1.0f, -1.0f, -1.0f,
+			 1.0f, -1.0f,  1.0f,
+			 1.0f,  1.0f,  1.0f,
+			 1.0f,  1.0f,  1.0f,
+			 1.0f,  1.0f, -1.0f,
+			 1.0f, -1.0f, -1.0f,
+
+			-1.0f, -1.0f,  1.0f,
+			-1.0f,  1.0f,  1.0f,
+			 1.0f,  1.0f,  1.0f,
+			 1.0f,  1.0f,  1.0f,
+			 1.0f, -1.0f,  1.0f,
+			-1.0f, -1.0f,  1.0f,
+
+			-1.0f,  1.0f, -1.0f,
+			 1.0f,  1.0f, -1.0f,
+			 1.0f,  1.0f,  1.0f,
+			 1.0f,  1.0f,  1.0f,
+			-1.0f,  1.0f,  1.0f,
+			-1.0f,  1.0f, -1.0f,
+
+			-1.0f, -1.0f, -1.0f,
+			-1.0f, -1.0f,  1.0f,
+			 1.0f, -1.0f, -1.0f,
+			 1.0f, -1.0f, -1.0f,
+			-1.0f, -1.0f,  1.0f,
+			 1.0f, -1.0f,  1.0f
+		};
+
+		// load skybox texture
+		std::vector<std::string> faces{
+				"Resources/skybox/right.jpg",
+				"Resources/skybox/left.jpg",
+				"Resources/skybox/top.jpg",
+				"Resources/skybox/bottom.jpg",
+				"Resources/skybox/front.jpg",
+				"Resources/skybox/back.jpg"
+		};
+		cubemapTexture = loadCubemap(faces);
+
+
+		glGenVertexArrays(1, &skyboxVAO);
+		glGenBuffers(1, &skyboxVBO);
+		glBindVertexArray(skyboxVAO);
+		glBindBuffer(GL_ARRAY_BUFFER, skyboxVBO);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(skyboxVertices), &skyboxVertices, GL_STATIC_DRAW);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+
+		skyboxShader.use();
+		skyboxShader.setInt("skybox", 0);
+	}
+
+	// draw skybox as last
+	glDepthFunc(GL_LEQUAL);
+	skyboxShader.use();
+	// skybox cube
+	glBindVertexArray(skyboxVAO);
+	glActiveTexture(DefaultTextureUnit);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
+	glDrawArrays(GL_TRIANGLES, 0, 36);
+	glBindVertexArray(0);
+	glDepthFunc(GL_LESS);
+}
+
+unsigned int debugVAO = 0;
+unsigned int debugVBO;
+void renderQuad()
+{
+	if (debugVAO == 0) {
+		float quadVertices[] = {
+			// positions        // texture Coords
+			-1.0f,  1.0f, 0.0f, 0.0f, 1.0f,
+			-1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
+			 1.0f,  1.0f, 0.0f, 1.0f, 1.0f,
+			 1.0f, -1.0f, 0.0f, 1.0f, 0.0f,
+		};
+		// setup plane VAO
+		glGenVertexArrays(1, &debugVAO);
+		glGenBuffers(1, &debugVBO);
+		glBindVertexArray(debugVAO);
+		glBindBuffer(GL_ARRAY_BUFFER, debugVBO);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+	}
+	glBindVertexArray(debugVAO);
+	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	glBindVertexArray(0);
+}
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+#include "IMGUI/imgui.h"
+
+#include "Shader.h"
+#include "ShaderPermutations.h"
+#include "ShaderBatch.h"
+#include "Camera.h"
+#include "Model.h"
+#include "LightManager.h"
+#include "ClusteredLights.h"
+#include "ShadowCascades.h"
+#include "ShadowAtlas.h"
+#include "PointShadows.h"
+#include "ShadowMoments.h"
+
+#define DefaultTextureUnit	GL_TEXTURE0
+#define ShadowMapUnit		GL_TEXTURE1
+// G-buffer of the deferred path, read by its lighting pass
+#define GBufferAlbedoUnit	GL_TEXTURE2
+#define GBufferNormalUnit	GL_TEXTURE3
+#define GBufferDepthUnit	GL_TEXTURE4
+// texture buffers of the clustered shading path, bound once per frame
+#define ClusterLightDataUnit	GL_TEXTURE5
+#define ClusterGridUnit			GL_TEXTURE6
+#define ClusterIndexUnit		GL_TEXTURE7
+// the shadow atlas with the point light shadows
+#define ShadowAtlasUnit			GL_TEXTURE8
+// prefiltered moments of the cascades, read instead of the depth by the EVSM filter
+#define ShadowMomentsUnit		GL_TEXTURE12
+
+// shaders used by the render passes
+struct SceneShaders {
+	// lit shaders, one permutation per combination of litFeatures()
+	ShaderPermutations lighting;
+	Shader lightCube;
+	ShaderPermutations model;
+	// lighting pass of the deferred path, one permutation per combination of litFeatures()
+	ShaderPermutations deferred;
+	Shader blending;
+	Shader framebuffer;
+	Shader skybox;
+	Shader reflect;
+	Shader refract;
+	Shader depth;
+	// depth pass into the point light faces of the shadow atlas
+	Shader pointDepth;
+	// the two passes of the moments' Gaussian, the first reads the cascades' depth
+	Shader momentsFromDepth;
+	Shader momentsBlur;
+	Shader debugDepthQuad;
+};
+
+// post processing effects
+enum Kernels {
+	DISABLED,
+	BLUR_KERNEL,
+	EDGE_DETECTION_KERNEL,
+	GRAYSCALE
+};
+
+// called with begin = true/false around every pass renderScene() runs, so profilers can time them
+typedef void (*PassCallback)(const char* name, bool begin);
+extern PassCallback passCallback;
+
+// passes an object of the scene is drawn in
+enum ObjectPasses {
+	MainPass			= 1 << 0,
+	ShadowCasterPass	= 1 << 1,
+	// alpha blended, drawn after the opaque objects
+	TransparentPass		= 1 << 2,
+	// animated every frame, never part of the shadow cache
+	DynamicObject		= 1 << 3
+};
+
+struct SceneObject {
+	// name of its pass in the profilers
+	const char* name;
+	unsigned int passes;
+	// draws every instance of the object, instances outside the shadow cascade are skipped
+	void (*draw)(Shader &shader);
+};
+
+extern const SceneObject sceneObjects[];
+extern const unsigned int SCENE_OBJECT_COUNT;
+
+// define models
+extern Model house;
+extern Model ori;
+extern VertexLayout modelVertexLayout;
+extern bool optimizeMeshes;
+
+extern const unsigned int SCR_WIDTH, SCR_HEIGHT;
+
+// camera
+extern Camera camera;
+
+// seconds used to animate the scene, set by the caller once per frame
+extern float sceneTime;
+
+// max number of lights
+extern const unsigned int NR_POINT_LIGHTS;
+extern const unsigned int NR_SPOT_LIGHTS;
+
+extern glm::vec3 pointLightPositions[];
+extern LightManager lightManager;
+// point lights added on top of the scene's own, for stress tests of the clustered path
+extern int extraLights;
+
+// shade the point and spot lights through the clustered light lists
+extern bool clusteredShading;
+extern ClusteredLights clusteredLights;
+
+// draw the floor and the models into the G-buffer and light them in one fullscreen pass
+extern bool deferredShading;
+// gbufferFramebuffer() uses these
+extern unsigned int gbufferFBO, gAlbedoShininess, gNormal, gDepth;
+
+// the shadow of the directional light falls from lightPos towards the origin
+extern glm::vec3 lightPos;
+// number of shadow cascades (1 to 4), the resolution of each and how far from the camera they reach
+extern int shadowCascadeCount;
+extern int shadowMapSize;
+extern float shadowDistance;
+extern ShadowCascades shadowCascades;
+// cascade drawCascadeCasters() is drawing, see shadowCulled()
+extern const glm::mat4* shadowCullMatrix;
+
+// depth texture the shadows of the point lights share, its size bounds their memory
+extern int shadowAtlasSize;
+extern ShadowAtlas shadowAtlas;
+// shadows of the point lights in the Lights block, the largest tile a face may get and how many
+// faces may be drawn again per frame
+extern bool pointLightShadows;
+extern int pointShadowSize;
+extern int pointShadowFaceBudget;
+extern PointShadows pointShadows;
+// light renderPointShadows() is drawing, see shadowCulled()
+extern int pointShadowCullLight;
+// cache the shadow depth of the static casters, see drawStaticCasters()
+extern bool shadowCache;
+// moments of the cascades for the EVSM shadow filter, only updated while it is selected
+extern ShadowMoments shadowMoments;
+
+// vfxFramebuffer() uses these
+extern unsigned int activeKernel;
+extern unsigned int framebuffer, textureColorbuffer, quadVAO, quadVBO;
+
+// framebuffer the final image is rendered into, 0 is the window
+extern unsigned int sceneFBO;
+
+// active lighting method (Phong or BlinnPhong)
+extern bool blinnPhong;
+// directional light shadows, their filter (ShadowFilters) and the width of the box and Poisson
+// filters in texels (odd)
+extern bool shadows;
+extern int shadowFilter;
+extern int pcfKernel;
+
+// ImGUI state
+extern ImVec4 clearColor;
+// house
+extern glm::vec3	HRotateAxis;
+extern float		HRotateAngle;
+extern glm::vec3	HTranslate;
+// ori
+extern glm::vec3	ORotateAxis;
+extern float		ORotateAngle;
+extern glm::vec3	OTranslate;
+// floor
+extern glm::vec3	FTranslate;
+extern glm::vec3	FRotateAxis;
+extern float		FRotate;
+
+extern glm::vec3	lightColors[];
+
+// mirror pos
+extern glm::vec3	MTranslate;
+extern glm::vec3	RTranslate;
+
+// projection and view matrices
+extern float cameraNear, cameraFar;
+extern glm::mat4 projection;
+extern glm::mat4 view;
+
+// compile the shaders, load the models and create the framebuffers
+void loadScene(SceneShaders &shaders);
+// same, but leaves the shaders compiling in the batch, they are ready once batch.Poll() returns true
+void loadScene(SceneShaders &shaders, ShaderBatch &batch);
+// render one frame: vfx pass, shadow pass, lit pass and post processing
+void renderScene(SceneShaders &shaders);
+// animate the lights and upload the changed ones into the Lights uniform block
+void updateLights();
+// compute the camera and shadow matrices and upload them into the FrameUniforms block
+void updateFrameUniforms();
+// bin the lights into the clusters of the camera frustum and bind the light lists
+void updateClusters();
+// invalidate the shadow cache if a static caster was moved
+void invalidateMovedCasters();
+// draws the scene objects casting shadows that are dynamic or not with shader. The static
+// casters only move through the ImGui controls and are cached when shadowCache is set, the
+// dynamic ones are drawn on top of the cached depth every frame.
+void drawShadowCasters(Shader &shader, bool dynamic);
+void drawCascadeCasters(SceneShaders &shaders, unsigned int cascade, bool dynamic);
+// texels a face of the light's shadow should have, from the size of its range on screen
+float pointShadowImportance(const glm::vec3 &position, float range);
+// draws the point light faces scheduled for this frame
+void renderPointShadows(SceneShaders &shaders);
+// warps, blurs and mipmaps the cascades' depth into shadowMoments
+void renderShadowMoments(SceneShaders &shaders);
+// model-space box lies outside the light frustum of the cascade or all scheduled faces of the
+// point light being drawn, otherwise sets the faceMask of shader for a point light. Always false
+// outside the shadow passes.
+bool shadowCulled(Shader &shader, const glm::mat4 &model, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax);
+void addExtraLight(unsigned int index);
+
+void vfxFramebuffer();
+void gbufferFramebuffer();
+// features the lit shaders are specialized for, from the settings above
+ShaderFeatures litFeatures();
+// the permutation of the lit shaders writing the G-buffer
+ShaderFeatures gbufferFeatures();
+unsigned int loadTexture(char const * path);
+unsigned int loadCubemap(std::vector<std::string> faces);
+void drawCubes(Shader &shader);
+void drawFloor(Shader &shader);
+void drawLightCube(Shader &shader);
+void drawModels(Shader &shader);
+void drawGrasses(Shader &shader);
+void drawWindows(Shader &shader);
+void drawSkybox(Shader &skyboxShader);
+void renderQuad();
@@ -1,129 +1,508 @@
 #include "Shader.h"
+#include "Profiler.h"
+#include "ShaderCache.h"
+#include "UniformBlocks.h"
 
-Shader::Shader(const GLchar * vertexPath, const GLchar * fragmentPath)
-{
-	std::string vertexCode;
-	std::string fragmentCode;
-	std::ifstream vShaderFile;
-	std::ifstream fShaderFile;
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+// active uniforms of a program in a flat hash table, plus the last value uploaded to each
+struct UniformTable {
+	// a name resolving to an entry, "lights" and "lights[0]" name the same one
+	struct Key {
+		std::string name;
+		unsigned int hash;
+		int entry;
+	};
+
+	struct Entry {
+		std::string name;
+		int location;
+		GLenum type;
+		// bytes of the cached value in values
+		unsigned int offset;
+		unsigned int size;
+		bool uploaded;
+		bool reported;
+	};
+
+	std::vector<Key> keys;
+	std::vector<Entry> entries;
+	// indices into keys, -1 marks an empty bucket, power of two sized
+	std::vector<int> buckets;
+	std::vector<unsigned char> values;
+};
+
+namespace {
+	// uniform blocks shared between shaders and their binding points
+	const struct {
+		const char* name;
+		GLuint binding;
+	} UNIFORM_BLOCKS[] = {
+		{ "Lights", LIGHTS_BLOCK_BINDING },
+		{ "FrameUniforms", FRAME_BLOCK_BINDING }
+	};
+
+	// program bound by the last Shader::use
+	unsigned int currentProgram = 0;
+
+	// include depth at which a cycle is assumed
+	const int MAX_INCLUDE_DEPTH = 16;
 
-	// ensure ifstream objects can throw exceptions
-	vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-	fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+	bool readFile(const std::string &path, std::string &code)
+	{
+		std::ifstream file;
+
+		// ensure ifstream objects can throw exceptions
+		file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+
+		try {
+			file.open(path.c_str());
+			std::stringstream stream;
+			stream << file.rdbuf();
+			file.close();
+			code = stream.str();
+			return true;
+		}
+		catch (std::ifstream::failure e) {
+			return false;
+		}
+	}
+
+	// Appends the file to source with every #include "path" line replaced by that file, paths are
+	// relative to the including file and every file is included once. #line directives keep compile
+	// errors pointing at the right line, the source string number is the file's index in files.
+	void appendSource(const std::string &path, std::string &source, std::vector<std::string> &files, int depth)
+	{
+		std::string code;
+		if (!readFile(path, code)) {
+			std::cout << "Error: Shader file not successfully read: " << path << std::endl;
+			return;
+		}
+		int fileIndex = (int)files.size();
+		files.push_back(path);
 
-	try {
-		// open files
-		vShaderFile.open(vertexPath);
-		fShaderFile.open(fragmentPath);
+		std::string directory = path.substr(0, path.find_last_of("/\\") + 1);
+		std::istringstream lines(code);
+		std::string line;
+		int lineNumber = 0;
+		while (std::getline(lines, line)) {
+			lineNumber++;
+			size_t start = line.find_first_not_of(" \t");
+			if (start == std::string::npos || line.compare(start, 8, "#include") != 0) {
+				source += line;
+				source += '\n';
+				continue;
+			}
 
-		// read file's content into the streams
-		std::stringstream vShaderStream, fShaderStream;
-		vShaderStream << vShaderFile.rdbuf();
-		fShaderStream << fShaderFile.rdbuf();
+			size_t open = line.find('"', start + 8);
+			size_t close = open == std::string::npos ? std::string::npos : line.find('"', open + 1);
+			if (close == std::string::npos || depth >= MAX_INCLUDE_DEPTH) {
+				std::cout << "Error::Shader: invalid #include in " << path << " line " << lineNumber << std::endl;
+				source += '\n';
+				continue;
+			}
+
+			std::string includePath = directory + line.substr(open + 1, close - open - 1);
+			if (std::find(files.begin(), files.end(), includePath) == files.end()) {
+				source += "#line 1 " + std::to_string(files.size()) + "\n";
+				appendSource(includePath, source, files, depth + 1);
+			}
+			source += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(fileIndex) + "\n";
+		}
+	}
+
+	// reads a shader with its includes resolved and the defines inserted after #version, which
+	// has to stay the first statement
+	std::string loadSource(const std::string &path, const std::string &defines)
+	{
+		std::string source;
+		std::vector<std::string> files;
+		appendSource(path, source, files, 0);
+		if (defines.empty())
+			return source;
+
+		size_t version = source.find("#version");
+		size_t lineEnd = version == std::string::npos ? std::string::npos : source.find('\n', version);
+		if (lineEnd == std::string::npos)
+			return defines + source;
+
+		int versionLine = (int)std::count(source.begin(), source.begin() + lineEnd, '\n') + 1;
+		return source.substr(0, lineEnd + 1) + defines + "#line " + std::to_string(versionLine + 1) + " 0\n" + source.substr(lineEnd + 1);
+	}
+
+	// FNV-1a
+	unsigned int hashName(const char* name, size_t length)
+	{
+		unsigned int hash = 2166136261u;
+		for (size_t i = 0; i < length; i++) {
+			hash ^= (unsigned char)name[i];
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	unsigned int typeSize(GLenum type)
+	{
+		switch (type) {
+		case GL_FLOAT_VEC2: case GL_INT_VEC2: case GL_BOOL_VEC2: return 8;
+		case GL_FLOAT_VEC3: case GL_INT_VEC3: case GL_BOOL_VEC3: return 12;
+		case GL_FLOAT_VEC4: case GL_INT_VEC4: case GL_BOOL_VEC4: case GL_FLOAT_MAT2: return 16;
+		case GL_FLOAT_MAT3: return 36;
+		case GL_FLOAT_MAT4: return 64;
+		default: return 4;
+		}
+	}
 
-		// close files
-		vShaderFile.close();
-		fShaderFile.close();
+	// whether a value of setterType may be uploaded to a uniform of uniformType
+	bool compatibleTypes(GLenum uniformType, GLenum setterType)
+	{
+		if (uniformType == setterType)
+			return true;
+		// glUniform1i also sets bools and samplers
+		return setterType == GL_INT && typeSize(uniformType) == 4 && uniformType != GL_FLOAT;
+	}
 
-		// convert stream into string
-		vertexCode = vShaderStream.str();
-		fragmentCode = fShaderStream.str();
+	void addKey(UniformTable &table, const std::string &name, int entry)
+	{
+		UniformTable::Key key;
+		key.name = name;
+		key.hash = hashName(name.c_str(), name.size());
+		key.entry = entry;
+		table.keys.push_back(key);
 	}
-	catch (std::ifstream::failure e) {
-		std::cout << "Error: Shader file not successfully read." << std::endl;
+
+	void addUniform(UniformTable &table, const std::string &name, int location, GLenum type)
+	{
+		addKey(table, name, (int)table.entries.size());
+
+		UniformTable::Entry entry;
+		entry.name = name;
+		entry.location = location;
+		entry.type = type;
+		entry.offset = (unsigned int)table.values.size();
+		entry.size = typeSize(type);
+		entry.uploaded = false;
+		entry.reported = false;
+		table.entries.push_back(entry);
+		table.values.resize(table.values.size() + entry.size);
 	}
+}
+
+Shader::Shader(const GLchar * vertexPath, const GLchar * fragmentPath, const std::string &defines, const GLchar* geometryPath)
+{
+	PROFILE_FUNCTION();
+
+	PendingProgram pending;
+	LoadSources(vertexPath, fragmentPath, defines, pending, geometryPath);
+	Submit(pending);
+	Finish(pending);
+}
+
+void Shader::LoadSources(const GLchar* vertexPath, const GLchar* fragmentPath, const std::string &defines, PendingProgram &pending, const GLchar* geometryPath)
+{
+	PROFILE_FUNCTION();
+
+	pending.vertexCode = loadSource(vertexPath, defines);
+	pending.fragmentCode = loadSource(fragmentPath, defines);
+	if (geometryPath != nullptr)
+		pending.geometryCode = loadSource(geometryPath, defines);
+	else
+		pending.geometryCode.clear();
+}
+
+void Shader::Submit(PendingProgram &pending)
+{
+	pending.vertex = pending.fragment = pending.geometry = 0;
 
-	const char* vShaderCode = vertexCode.c_str();
-	const char* fShaderCode = fragmentCode.c_str();
+	// reuse the program linked on an earlier run if the sources and the driver are unchanged
+	ID = ShaderCache::Load(pending.vertexCode, pending.fragmentCode, pending.geometryCode);
+	if (ID != 0)
+		return;
 
-	unsigned int vertex, fragment;
+	const char* vShaderCode = pending.vertexCode.c_str();
+	const char* fShaderCode = pending.fragmentCode.c_str();
 
-	// compile shaders
-	vertex = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertex, 1, &vShaderCode, nullptr);
-	glCompileShader(vertex);
-	checkCompileErrors(vertex, "VERTEX");
+	// compile shaders, their status is checked in Finish so the driver may work in the background
+	pending.vertex = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(pending.vertex, 1, &vShaderCode, nullptr);
+	glCompileShader(pending.vertex);
 
-	fragment = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragment, 1, &fShaderCode, nullptr);
-	glCompileShader(fragment);
-	checkCompileErrors(fragment, "FRAGMENT");
+	pending.fragment = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(pending.fragment, 1, &fShaderCode, nullptr);
+	glCompileShader(pending.fragment);
+
+	if (!pending.geometryCode.empty()) {
+		const char* gShaderCode = pending.geometryCode.c_str();
+		pending.geometry = glCreateShader(GL_GEOMETRY_SHADER);
+		glShaderSource(pending.geometry, 1, &gShaderCode, nullptr);
+		glCompileShader(pending.geometry);
+	}
 
 	// shader program
 	ID = glCreateProgram();
-	glAttachShader(ID, vertex);
-	glAttachShader(ID, fragment);
+	glAttachShader(ID, pending.vertex);
+	glAttachShader(ID, pending.fragment);
+	if (pending.geometry != 0)
+		glAttachShader(ID, pending.geometry);
+	ShaderCache::PrepareProgram(ID);
 	glLinkProgram(ID);
-	checkCompileErrors(ID, "PROGRAM");
+}
+
+void Shader::Finish(PendingProgram &pending)
+{
+	if (pending.vertex != 0) {
+		checkCompileErrors(pending.vertex, "VERTEX");
+		checkCompileErrors(pending.fragment, "FRAGMENT");
+		if (pending.geometry != 0)
+			checkCompileErrors(pending.geometry, "GEOMETRY");
+		checkCompileErrors(ID, "PROGRAM");
+
+		int success;
+		glGetProgramiv(ID, GL_LINK_STATUS, &success);
+		if (success)
+			ShaderCache::Store(ID, pending.vertexCode, pending.fragmentCode, pending.geometryCode);
 
-	// delete shaders as they're linked and aren't needed anymore
-	glDeleteShader(vertex);
-	glDeleteShader(fragment);
+		// delete shaders as they're linked and aren't needed anymore
+		glDeleteShader(pending.vertex);
+		glDeleteShader(pending.fragment);
+		if (pending.geometry != 0)
+			glDeleteShader(pending.geometry);
+		pending.vertex = pending.fragment = pending.geometry = 0;
+	}
+
+	loadUniforms();
+	bindUniformBlocks();
 }
 
 void Shader::use()
 {
 	glUseProgram(ID);
+	currentProgram = ID;
+}
+
+void Shader::bindUniformBlocks()
+{
+	for (size_t i = 0; i < sizeof(UNIFORM_BLOCKS) / sizeof(UNIFORM_BLOCKS[0]); i++) {
+		GLuint index = glGetUniformBlockIndex(ID, UNIFORM_BLOCKS[i].name);
+		if (index != GL_INVALID_INDEX)
+			glUniformBlockBinding(ID, index, UNIFORM_BLOCKS[i].binding);
+	}
+}
+
+void Shader::loadUniforms()
+{
+	GLint count = 0, maxLength = 0;
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+	uniforms = std::make_shared<UniformTable>();
+	UniformTable &table = *uniforms;
+	std::vector<GLchar> nameBuffer(maxLength + 1);
+	for (GLint i = 0; i < count; i++) {
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = GL_NONE;
+		glGetActiveUniform(ID, (GLuint)i, (GLsizei)nameBuffer.size(), &length, &size, &type, &nameBuffer[0]);
+		std::string name(&nameBuffer[0], length);
+
+		// members of uniform blocks have no location
+		int location = glGetUniformLocation(ID, name.c_str());
+		if (location < 0)
+			continue;
+
+		// arrays of basic types are reported once as "name[0]", register "name" and every element
+		size_t bracket = name.size() >= 3 ? name.size() - 3 : std::string::npos;
+		if (bracket != std::string::npos && name.compare(bracket, 3, "[0]") == 0) {
+			std::string base = name.substr(0, bracket);
+			addKey(table, base, (int)table.entries.size());
+			for (GLint element = 0; element < size; element++) {
+				std::string elementName = base + '[' + std::to_string(element) + ']';
+				addUniform(table, elementName, glGetUniformLocation(ID, elementName.c_str()), type);
+			}
+		} else
+			addUniform(table, name, location, type);
+	}
+
+	// open addressing at a load factor of at most 1/2
+	size_t buckets = 16;
+	while (buckets < table.keys.size() * 2)
+		buckets *= 2;
+	table.buckets.assign(buckets, -1);
+	for (size_t i = 0; i < table.keys.size(); i++) {
+		size_t bucket = table.keys[i].hash & (buckets - 1);
+		while (table.buckets[bucket] >= 0)
+			bucket = (bucket + 1) & (buckets - 1);
+		table.buckets[bucket] = (int)i;
+	}
+}
+
+UniformHandle Shader::getUniform(const std::string &name) const
+{
+	UniformHandle uniform;
+	if (!uniforms) {
+		uniform.location = glGetUniformLocation(ID, name.c_str());
+		return uniform;
+	}
+
+	const UniformTable &table = *uniforms;
+	if (table.buckets.empty())
+		return uniform;
+
+	unsigned int hash = hashName(name.c_str(), name.size());
+	size_t mask = table.buckets.size() - 1;
+	for (size_t bucket = hash & mask;; bucket = (bucket + 1) & mask) {
+		int index = table.buckets[bucket];
+		if (index < 0)
+			return uniform;
+
+		const UniformTable::Key &key = table.keys[index];
+		if (key.hash == hash && key.name == name) {
+			const UniformTable::Entry &entry = table.entries[key.entry];
+			uniform.location = entry.location;
+			uniform.index = key.entry;
+			uniform.type = entry.type;
+			return uniform;
+		}
+	}
+}
+
+bool Shader::changed(const UniformHandle &uniform, GLenum type, const void* value, size_t size) const
+{
+	if (!uniforms || uniform.index < 0)
+		return uniform.location >= 0;
+
+	UniformTable::Entry &entry = uniforms->entries[uniform.index];
+	if (!compatibleTypes(entry.type, type) && !entry.reported) {
+		std::cout << "Error::Shader: uniform " << entry.name << " is set with a value of the wrong type." << std::endl;
+		entry.reported = true;
+	}
+
+	// glUniform writes to the bound program, only then does the cache follow the program
+	if (currentProgram != ID || size > entry.size)
+		return true;
+
+	unsigned char* cached = &uniforms->values[entry.offset];
+	if (entry.uploaded && std::memcmp(cached, value, size) == 0)
+		return false;
+
+	std::memcpy(cached, value, size);
+	entry.uploaded = true;
+	return true;
 }
 
 void Shader::setBool(const std::string & name, bool value) const
 {
-	glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+	setBool(getUniform(name), value);
 }
 
 void Shader::setInt(const std::string & name, int value) const
 {
-	glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+	setInt(getUniform(name), value);
 }
 
 void Shader::setFloat(const std::string & name, float value) const
 {
-	glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+	setFloat(getUniform(name), value);
 }
 
 void Shader::setVec2(const std::string & name, float x, float y) const
 {
-	glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+	setVec2(getUniform(name), glm::vec2(x, y));
 }
 
 void Shader::setVec2(const std::string & name, glm::vec2 &value) const
 {
-	glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+	setVec2(getUniform(name), value);
 }
 
 void Shader::setVec3(const std::string & name, float x, float y, float z) const
 {
-	glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+	setVec3(getUniform(name), glm::vec3(x, y, z));
 }
 
 void Shader::setVec3(const std::string & name, glm::vec3 &value) const
 {
-	glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+	setVec3(getUniform(name), value);
 }
 
 void Shader::setVec4(const std::string & name, float x, float y, float z, float w) const
 {
-	glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+	setVec4(getUniform(name), glm::vec4(x, y, z, w));
 }
 
 void Shader::setVec4(const std::string & name, glm::vec4 &value) const
 {
-	glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+	setVec4(getUniform(name), value);
 }
 
 void Shader::setMat2(const std::string & name, glm::mat2 &value) const
 {
-	glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
+	setMat2(getUniform(name), value);
 }
 
 void Shader::setMat3(const std::string & name, glm::mat3 &value) const
 {
-	glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
+	setMat3(getUniform(name), value);
 }
 
 void Shader::setMat4(const std::string & name, glm::mat4 &value) const
 {
-	glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
+	setMat4(getUniform(name), value);
+}
+
+void Shader::setBool(const UniformHandle &uniform, bool value) const
+{
+	setInt(uniform, (int)value);
+}
+
+void Shader::setInt(const UniformHandle &uniform, int value) const
+{
+	if (changed(uniform, GL_INT, &value, sizeof(value)))
+		glUniform1i(uniform.location, value);
+}
+
+void Shader::setFloat(const UniformHandle &uniform, float value) const
+{
+	if (changed(uniform, GL_FLOAT, &value, sizeof(value)))
+		glUniform1f(uniform.location, value);
+}
+
+void Shader::setVec2(const UniformHandle &uniform, const glm::vec2 &value) const
+{
+	if (changed(uniform, GL_FLOAT_VEC2, glm::value_ptr(value), sizeof(value)))
+		glUniform2fv(uniform.location, 1, glm::value_ptr(value));
+}
+
+void Shader::setVec3(const UniformHandle &uniform, const glm::vec3 &value) const
+{
+	if (changed(uniform, GL_FLOAT_VEC3, glm::value_ptr(value), sizeof(value)))
+		glUniform3fv(uniform.location, 1, glm::value_ptr(value));
+}
+
+void Shader::setVec4(const UniformHandle &uniform, const glm::vec4 &value) const
+{
+	if (changed(uniform, GL_FLOAT_VEC4, glm::value_ptr(value), sizeof(value)))
+		glUniform4fv(uniform.location, 1, glm::value_ptr(value));
+}
+
+void Shader::setMat2(const UniformHandle &uniform, const glm::mat2 &value) const
+{
+	if (changed(uniform, GL_FLOAT_MAT2, glm::value_ptr(value), sizeof(value)))
+		glUniformMatrix2fv(uniform.location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void Shader::setMat3(const UniformHandle &uniform, const glm::mat3 &value) const
+{
+	if (changed(uniform, GL_FLOAT_MAT3, glm::value_ptr(value), sizeof(value)))
+		glUniformMatrix3fv(uniform.location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void Shader::setMat4(const UniformHandle &uniform, const glm::mat4 &value) const
+{
+	if (changed(uniform, GL_FLOAT_MAT4, glm::value_ptr(value), sizeof(value)))
+		glUniformMatrix4fv(uniform.location, 1, GL_FALSE, glm::value_ptr(value));
 }
 
 void Shader::checkCompileErrors(unsigned int shader, std::string type)
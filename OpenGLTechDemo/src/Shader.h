@@ -10,18 +10,56 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <memory>
+
+struct UniformTable;
+
+// an active uniform of a shader, resolved once with Shader::getUniform and reused every frame
+struct UniformHandle {
+	int location;
+	// entry in the shader's uniform table, -1 if the shader has no such active uniform
+	int index;
+	GLenum type;
+
+	UniformHandle() : location(-1), index(-1), type(GL_NONE) {}
+	bool valid() const { return index >= 0; }
+};
+
+// a program handed to the driver whose compile and link status is not checked yet
+struct PendingProgram {
+	unsigned int vertex;
+	unsigned int fragment;
+	// 0 without a geometry stage
+	unsigned int geometry;
+	// preprocessed sources, also the key of the program in the ShaderCache
+	std::string vertexCode;
+	std::string fragmentCode;
+	std::string geometryCode;
+};
 
 class Shader {
 public:
-	unsigned int ID;
+	unsigned int ID = 0;
 
 	Shader() = default;
-	Shader(const GLchar* vertexPath, const GLchar* fragmentPath);
+	// #include "path" lines are resolved relative to the including file, defines are inserted
+	// after the #version line of every stage. The geometry stage is optional.
+	Shader(const GLchar* vertexPath, const GLchar* fragmentPath, const std::string &defines = std::string(), const GLchar* geometryPath = nullptr);
+
+	// The constructor split into steps for ShaderBatch. LoadSources only reads files and may run on
+	// any thread, Submit hands the program to the driver without waiting for it and Finish checks
+	// the result and enumerates the uniforms once the driver is done.
+	static void LoadSources(const GLchar* vertexPath, const GLchar* fragmentPath, const std::string &defines, PendingProgram &pending, const GLchar* geometryPath = nullptr);
+	void Submit(PendingProgram &pending);
+	void Finish(PendingProgram &pending);
 
 	// use/activate the shader
 	void use();
 
-	// utility functions for setting uniforms
+	// active uniforms are enumerated once after linking, names resolve without asking the driver
+	UniformHandle getUniform(const std::string &name) const;
+
+	// utility functions for setting uniforms, uploads are skipped when the value is unchanged
 	void setBool(const std::string &name, bool value) const;
 	void setInt(const std::string &name, int value) const;
 	void setFloat(const std::string &name, float value) const;
@@ -35,7 +73,24 @@ public:
 	void setMat3(const std::string &name, glm::mat3 &value) const;
 	void setMat4(const std::string &name, glm::mat4 &value) const;
 
+	void setBool(const UniformHandle &uniform, bool value) const;
+	void setInt(const UniformHandle &uniform, int value) const;
+	void setFloat(const UniformHandle &uniform, float value) const;
+	void setVec2(const UniformHandle &uniform, const glm::vec2 &value) const;
+	void setVec3(const UniformHandle &uniform, const glm::vec3 &value) const;
+	void setVec4(const UniformHandle &uniform, const glm::vec4 &value) const;
+	void setMat2(const UniformHandle &uniform, const glm::mat2 &value) const;
+	void setMat3(const UniformHandle &uniform, const glm::mat3 &value) const;
+	void setMat4(const UniformHandle &uniform, const glm::mat4 &value) const;
+
 	~Shader();
 private:
+	// shared by every copy of the shader, Light and Material hold copies
+	std::shared_ptr<UniformTable> uniforms;
+
 	void checkCompileErrors(unsigned int shader, std::string type);
+	void loadUniforms();
+	void bindUniformBlocks();
+	// false if the value is already in the program and the upload can be skipped
+	bool changed(const UniformHandle &uniform, GLenum type, const void* value, size_t size) const;
 };
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "ShaderBatch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <thread>
+
+#include "Profiler.h"
+
+// GL_KHR_parallel_shader_compile
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR	0x91B0
+#define GL_COMPLETION_STATUS_KHR			0x91B1
+
+namespace {
+	typedef void (APIENTRYP MaxShaderCompilerThreadsProc)(GLuint count);
+
+	bool parallel = false;
+
+	// reading a few KB of shader text is quick, more threads would mostly cost their startup
+	const unsigned int MAX_READERS = 4;
+
+	bool hasExtension(const char* name)
+	{
+		GLint count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+		for (GLint i = 0; i < count; i++) {
+			const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+			if (extension && std::strcmp(extension, name) == 0)
+				return true;
+		}
+		return false;
+	}
+
+	// true when querying the status of the program would not block
+	bool ready(const PendingProgram &pending, GLuint program)
+	{
+		// linked from the ShaderCache, there is nothing to wait for
+		if (pending.vertex == 0)
+			return true;
+
+		GLint complete = GL_FALSE;
+		glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &complete);
+		return complete == GL_TRUE;
+	}
+}
+
+bool ShaderBatch::Init(GLADloadproc load)
+{
+	parallel = false;
+	if (!hasExtension("GL_KHR_parallel_shader_compile") && !hasExtension("GL_ARB_parallel_shader_compile"))
+		return false;
+
+	// the KHR and ARB entry points share the enum values
+	MaxShaderCompilerThreadsProc maxShaderCompilerThreads = (MaxShaderCompilerThreadsProc)load("glMaxShaderCompilerThreadsKHR");
+	if (maxShaderCompilerThreads == nullptr)
+		maxShaderCompilerThreads = (MaxShaderCompilerThreadsProc)load("glMaxShaderCompilerThreadsARB");
+	if (maxShaderCompilerThreads == nullptr)
+		return false;
+
+	// 0xFFFFFFFF leaves the number of threads to the driver
+	maxShaderCompilerThreads(0xFFFFFFFFu);
+	parallel = true;
+	return true;
+}
+
+bool ShaderBatch::ParallelCompile()
+{
+	return parallel;
+}
+
+void ShaderBatch::Add(Shader* target, const GLchar* vertexPath, const GLchar* fragmentPath, const std::string &defines, const GLchar* geometryPath)
+{
+	Entry entry;
+	entry.target = target;
+	entry.vertexPath = vertexPath;
+	entry.fragmentPath = fragmentPath;
+	entry.geometryPath = geometryPath != nullptr ? geometryPath : "";
+	entry.defines = defines;
+	entry.pending.vertex = entry.pending.fragment = entry.pending.geometry = 0;
+	entry.done = false;
+	entries.push_back(entry);
+}
+
+void ShaderBatch::Submit()
+{
+	PROFILE_FUNCTION();
+
+	if (submitted)
+		return;
+	submitted = true;
+
+	// file reads and #include resolution don't touch GL, a few workers take the programs in order
+	std::vector<std::promise<void>> loaded(entries.size());
+	std::atomic<unsigned int> next(0);
+	unsigned int workerCount = std::min(std::max(std::thread::hardware_concurrency(), 1u), MAX_READERS);
+	workerCount = std::min(workerCount, (unsigned int)entries.size());
+	std::vector<std::thread> workers;
+	for (unsigned int w = 0; w < workerCount; w++)
+		workers.push_back(std::thread([this, &loaded, &next]() {
+			for (unsigned int i = next++; i < entries.size(); i = next++) {
+				Entry &entry = entries[i];
+				Shader::LoadSources(entry.vertexPath.c_str(), entry.fragmentPath.c_str(), entry.defines, entry.pending,
+					entry.geometryPath.empty() ? nullptr : entry.geometryPath.c_str());
+				loaded[i].set_value();
+			}
+		}));
+
+	// GL calls stay on the thread owning the context, programs are submitted as their sources arrive
+	for (unsigned int i = 0; i < entries.size(); i++) {
+		loaded[i].get_future().wait();
+		entries[i].target->Submit(entries[i].pending);
+	}
+	for (std::thread &worker : workers)
+		worker.join();
+}
+
+bool ShaderBatch::Poll()
+{
+	PROFILE_FUNCTION();
+
+	Submit();
+	for (Entry &entry : entries) {
+		if (entry.done)
+			continue;
+		if (parallel) {
+			if (ready(entry.pending, entry.target->ID))
+				finish(entry);
+		}
+		else {
+			// the status query compiles the program, so keep every call short
+			finish(entry);
+			break;
+		}
+	}
+	return finished == entries.size();
+}
+
+void ShaderBatch::Finish()
+{
+	PROFILE_FUNCTION();
+
+	Submit();
+	for (Entry &entry : entries)
+		if (!entry.done)
+			finish(entry);
+}
+
+void ShaderBatch::finish(Entry &entry)
+{
+	entry.target->Finish(entry.pending);
+	// the sources are only kept as the ShaderCache key
+	entry.pending.vertexCode.clear();
+	entry.pending.fragmentCode.clear();
+	entry.pending.geometryCode.clear();
+	entry.done = true;
+	finished++;
+}
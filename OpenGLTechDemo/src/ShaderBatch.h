@@ -0,0 +1,51 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+
+#include "Shader.h"
+
+// Compiles many shaders at once. Submit() reads every source file on worker threads and hands all
+// programs to the driver before checking any of them, Poll() then finishes the programs the driver
+// is done with without blocking, so the caller can keep drawing a loading screen meanwhile.
+// With GL_KHR_parallel_shader_compile the driver compiles on its own threads; without it the
+// compile happens when the status is queried and Poll() finishes one program per call.
+class ShaderBatch {
+public:
+	// loads glMaxShaderCompilerThreadsKHR, which our GL 3.3 glad does not, and lets the driver
+	// use as many compiler threads as it likes. Must be called after gladLoadGLLoader.
+	static bool Init(GLADloadproc load);
+	static bool ParallelCompile();
+
+	// target is assigned the compiled shader by Poll() or Finish() and must outlive the batch
+	void Add(Shader* target, const GLchar* vertexPath, const GLchar* fragmentPath, const std::string &defines = std::string(), const GLchar* geometryPath = nullptr);
+
+	void Submit();
+	// finishes the programs that are ready, returns true once all of them are
+	bool Poll();
+	// blocks until every program is finished
+	void Finish();
+
+	unsigned int Count() const { return (unsigned int)entries.size(); }
+	unsigned int Finished() const { return finished; }
+
+private:
+	struct Entry {
+		Shader* target;
+		std::string vertexPath;
+		std::string fragmentPath;
+		// empty without a geometry stage
+		std::string geometryPath;
+		std::string defines;
+		PendingProgram pending;
+		bool done;
+	};
+
+	std::vector<Entry> entries;
+	unsigned int finished = 0;
+	bool submitted = false;
+
+	void finish(Entry &entry);
+};
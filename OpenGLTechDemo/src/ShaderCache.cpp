@@ -0,0 +1,229 @@
+#include "ShaderCache.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#include "Profiler.h"
+
+// GL_ARB_get_program_binary, not part of our glad
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT	0x8257
+#define GL_PROGRAM_BINARY_LENGTH			0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS		0x87FE
+#endif
+
+namespace {
+	typedef void (APIENTRYP GetProgramBinaryProc)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+	typedef void (APIENTRYP ProgramBinaryProc)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+	typedef void (APIENTRYP ProgramParameteriProc)(GLuint program, GLenum pname, GLint value);
+
+	const char CACHE_MAGIC[4] = { 'O', 'G', 'S', 'C' };
+	const unsigned int CACHE_VERSION = 1;
+
+	struct CacheHeader {
+		char magic[4];
+		unsigned int version;
+		unsigned long long key;
+		GLenum format;
+		GLint length;
+	};
+
+	GetProgramBinaryProc getProgramBinary = nullptr;
+	ProgramBinaryProc programBinary = nullptr;
+	ProgramParameteriProc programParameteri = nullptr;
+
+	bool enabled = false;
+	std::string cacheDirectory;
+	// vendor, renderer and version of the driver, part of every key
+	std::string driver;
+	unsigned int hits = 0;
+	unsigned int misses = 0;
+
+	// FNV-1a, 64 bit
+	unsigned long long hashText(unsigned long long hash, const std::string &text)
+	{
+		for (size_t i = 0; i < text.size(); i++) {
+			hash ^= (unsigned char)text[i];
+			hash *= 1099511628211ull;
+		}
+		// separator, so moving text from one source to the next changes the key
+		hash ^= 0xFF;
+		hash *= 1099511628211ull;
+		return hash;
+	}
+
+	unsigned long long cacheKey(const std::string &vertexCode, const std::string &fragmentCode, const std::string &geometryCode)
+	{
+		unsigned long long hash = 14695981039346656037ull;
+		hash = hashText(hash, driver);
+		hash = hashText(hash, vertexCode);
+		hash = hashText(hash, fragmentCode);
+		// only hashed when present, so the keys of the other programs stay the same
+		if (!geometryCode.empty())
+			hash = hashText(hash, geometryCode);
+		return hash;
+	}
+
+	std::string cachePath(unsigned long long key)
+	{
+		std::ostringstream path;
+		path << cacheDirectory << "/" << std::hex << key << ".bin";
+		return path.str();
+	}
+
+	void makeDirectory(const std::string &path)
+	{
+#if defined(_WIN32)
+		_mkdir(path.c_str());
+#else
+		mkdir(path.c_str(), 0755);
+#endif
+	}
+
+	bool hasExtension(const char* name)
+	{
+		GLint count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+		for (GLint i = 0; i < count; i++) {
+			const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+			if (extension && std::strcmp(extension, name) == 0)
+				return true;
+		}
+		return false;
+	}
+
+	const char* glString(GLenum name)
+	{
+		const char* value = (const char*)glGetString(name);
+		return value ? value : "";
+	}
+}
+
+bool ShaderCache::Init(GLADloadproc load, const std::string &directory)
+{
+	enabled = false;
+	GLint major = 0, minor = 0;
+	glGetIntegerv(GL_MAJOR_VERSION, &major);
+	glGetIntegerv(GL_MINOR_VERSION, &minor);
+	if (major * 10 + minor < 41 && !hasExtension("GL_ARB_get_program_binary")) {
+		std::cout << "ShaderCache: program binaries are not supported, shaders are compiled on every run." << std::endl;
+		return false;
+	}
+
+	getProgramBinary = (GetProgramBinaryProc)load("glGetProgramBinary");
+	programBinary = (ProgramBinaryProc)load("glProgramBinary");
+	programParameteri = (ProgramParameteriProc)load("glProgramParameteri");
+	GLint formats = 0;
+	if (getProgramBinary && programBinary && programParameteri)
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	if (formats == 0) {
+		std::cout << "ShaderCache: the driver offers no program binary formats, shaders are compiled on every run." << std::endl;
+		return false;
+	}
+
+	driver = std::string(glString(GL_VENDOR)) + "\n" + glString(GL_RENDERER) + "\n" + glString(GL_VERSION);
+	cacheDirectory = directory;
+	makeDirectory(cacheDirectory);
+	enabled = true;
+	return true;
+}
+
+bool ShaderCache::Enabled()
+{
+	return enabled;
+}
+
+GLuint ShaderCache::Load(const std::string &vertexCode, const std::string &fragmentCode, const std::string &geometryCode)
+{
+	if (!enabled)
+		return 0;
+
+	PROFILE_FUNCTION();
+
+	unsigned long long key = cacheKey(vertexCode, fragmentCode, geometryCode);
+	std::ifstream in(cachePath(key).c_str(), std::ios::binary);
+	CacheHeader header;
+	if (!in || !in.read((char*)&header, sizeof(header))
+		|| std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION
+		|| header.key != key || header.length <= 0) {
+		misses++;
+		return 0;
+	}
+
+	std::vector<char> binary(header.length);
+	if (!in.read(&binary[0], header.length)) {
+		misses++;
+		return 0;
+	}
+
+	GLuint program = glCreateProgram();
+	programBinary(program, header.format, &binary[0], header.length);
+	GLint success = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (!success) {
+		// the driver changed in a way its version string does not show, recompile
+		glDeleteProgram(program);
+		misses++;
+		return 0;
+	}
+
+	hits++;
+	return program;
+}
+
+void ShaderCache::PrepareProgram(GLuint program)
+{
+	if (enabled)
+		programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+void ShaderCache::Store(GLuint program, const std::string &vertexCode, const std::string &fragmentCode, const std::string &geometryCode)
+{
+	if (!enabled)
+		return;
+
+	PROFILE_FUNCTION();
+
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+		return;
+
+	CacheHeader header;
+	std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	header.version = CACHE_VERSION;
+	header.key = cacheKey(vertexCode, fragmentCode, geometryCode);
+	header.format = 0;
+	std::vector<char> binary(length);
+	getProgramBinary(program, length, &header.length, &header.format, &binary[0]);
+	if (header.length <= 0)
+		return;
+
+	std::string path = cachePath(header.key);
+	std::ofstream out(path.c_str(), std::ios::binary);
+	if (!out) {
+		std::cout << "Error::ShaderCache: could not write " << path << std::endl;
+		return;
+	}
+	out.write((const char*)&header, sizeof(header));
+	out.write(&binary[0], header.length);
+}
+
+unsigned int ShaderCache::Hits()
+{
+	return hits;
+}
+
+unsigned int ShaderCache::Misses()
+{
+	return misses;
+}
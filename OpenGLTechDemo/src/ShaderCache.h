@@ -0,0 +1,28 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <string>
+
+// On-disk cache of linked shader programs through GL_ARB_get_program_binary (core in 4.1).
+// Binaries are stored under a hash of the shader sources and the driver's vendor, renderer and
+// version strings, so an edited shader or an updated driver misses the cache and is compiled
+// from source again. Binaries the driver refuses to load are treated as misses as well.
+namespace ShaderCache {
+	// loads the program binary entry points, which our GL 3.3 glad does not, and creates the
+	// cache directory. The cache stays off when the driver offers no binary formats.
+	// Must be called after gladLoadGLLoader.
+	bool Init(GLADloadproc load, const std::string &directory = "ShaderCache");
+	bool Enabled();
+
+	// program linked from the cached binary of these sources, 0 on a miss, geometryCode is empty
+	// for programs without a geometry stage
+	GLuint Load(const std::string &vertexCode, const std::string &fragmentCode, const std::string &geometryCode = std::string());
+	// call before glLinkProgram so the driver keeps the binary of the program retrievable
+	void PrepareProgram(GLuint program);
+	// writes the binary of a linked program, replacing a stale one
+	void Store(GLuint program, const std::string &vertexCode, const std::string &fragmentCode, const std::string &geometryCode = std::string());
+
+	unsigned int Hits();
+	unsigned int Misses();
+}
@@ -0,0 +1,72 @@
+#include "ShaderPermutations.h"
+
+#include <sstream>
+
+#include "Profiler.h"
+
+ShaderFeatures::ShaderFeatures() : blinnPhong(true), shadows(true), shadowFilter(ShadowFilterBox), pcfKernel(3), pointLights(0), spotLights(0), clustered(false), gbuffer(false), shadowCascades(1), pointShadows(false)
+{
+}
+
+unsigned int ShaderFeatures::Mask() const
+{
+	return (blinnPhong ? 1u : 0u)
+		| (shadows ? 2u : 0u)
+		| (pcfKernel & 0xF) << 2
+		| (pointLights & 0xF) << 6
+		| (spotLights & 0xF) << 10
+		| (clustered ? 1u << 14 : 0u)
+		| (gbuffer ? 1u << 15 : 0u)
+		| (shadowCascades & 0x7) << 16
+		| (pointShadows ? 1u << 19 : 0u)
+		| (shadowFilter & 0x7) << 20;
+}
+
+std::string ShaderFeatures::Defines() const
+{
+	std::ostringstream defines;
+	if (blinnPhong)
+		defines << "#define BLINN_PHONG\n";
+	if (shadows)
+		defines << "#define SHADOWS\n";
+	defines << "#define SHADOW_FILTER " << shadowFilter << "\n";
+	defines << "#define PCF_KERNEL " << pcfKernel << "\n";
+	defines << "#define NR_POINT_LIGHTS " << pointLights << "\n";
+	defines << "#define NR_SPOT_LIGHTS " << spotLights << "\n";
+	if (clustered)
+		defines << "#define CLUSTERED\n";
+	if (gbuffer)
+		defines << "#define GBUFFER\n";
+	defines << "#define SHADOW_CASCADES " << shadowCascades << "\n";
+	if (pointShadows)
+		defines << "#define POINT_SHADOWS\n";
+	return defines.str();
+}
+
+ShaderPermutations::ShaderPermutations(const GLchar* vertexPath, const GLchar* fragmentPath)
+	: vertexPath(vertexPath), fragmentPath(fragmentPath)
+{
+}
+
+Shader& ShaderPermutations::Get(const ShaderFeatures &features)
+{
+	unsigned int mask = features.Mask();
+	std::map<unsigned int, Shader>::iterator it = permutations.find(mask);
+	if (it != permutations.end())
+		return it->second;
+
+	PROFILE_ZONE("ShaderPermutations compile");
+	Shader &shader = permutations[mask];
+	shader = Shader(vertexPath.c_str(), fragmentPath.c_str(), features.Defines());
+	return shader;
+}
+
+void ShaderPermutations::Add(const ShaderFeatures &features, ShaderBatch &batch)
+{
+	unsigned int mask = features.Mask();
+	if (permutations.find(mask) != permutations.end())
+		return;
+
+	// std::map keeps the address of the entry stable while the batch compiles it
+	batch.Add(&permutations[mask], vertexPath.c_str(), fragmentPath.c_str(), features.Defines());
+}
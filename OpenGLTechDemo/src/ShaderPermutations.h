@@ -0,0 +1,68 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "Shader.h"
+#include "ShaderBatch.h"
+
+// filter of the directional light's shadow, SHADOW_FILTER_* in include/shadows.glsl
+enum ShadowFilters {
+	ShadowFilterBox,
+	ShadowFilterBilinear,
+	ShadowFilterFourTap,
+	ShadowFilterPoisson,
+	// prefiltered exponential variance shadow maps, see ShadowMoments
+	ShadowFilterEvsm,
+	SHADOW_FILTER_COUNT
+};
+
+// compile-time features of the lit shaders (include/lights.glsl and include/shadows.glsl)
+// and of the deferred lighting pass
+struct ShaderFeatures {
+	bool blinnPhong;
+	bool shadows;
+	// one of ShadowFilters
+	unsigned int shadowFilter;
+	// width of the box and Poisson shadow filters in texels, odd, 1 to 15
+	unsigned int pcfKernel;
+	unsigned int pointLights;
+	unsigned int spotLights;
+	// point and spot lights from the clustered light lists, the counts above are ignored
+	bool clustered;
+	// write the G-buffer of the deferred path instead of shading, the light features are ignored
+	bool gbuffer;
+	// cascades of the directional shadow map, 1 to 4
+	unsigned int shadowCascades;
+	// shadows of the point lights in the shadow atlas
+	bool pointShadows;
+
+	ShaderFeatures();
+
+	// key of the permutation: bit 0 Blinn-Phong, bit 1 shadows, 4 bits each for the PCF
+	// kernel, the point light count and the spot light count, bit 14 clustered, bit 15 G-buffer,
+	// 3 bits for the cascade count, bit 19 point light shadows, 3 bits for the shadow filter
+	unsigned int Mask() const;
+	// #define lines selecting the features
+	std::string Defines() const;
+};
+
+// A shader compiled once per combination of features it is drawn with. Every permutation is
+// specialized by #defines, so disabled features cost nothing per fragment instead of being
+// skipped by a uniform branch.
+class ShaderPermutations {
+public:
+	ShaderPermutations() = default;
+	ShaderPermutations(const GLchar* vertexPath, const GLchar* fragmentPath);
+
+	// the permutation for these features, compiled on first use
+	Shader& Get(const ShaderFeatures &features);
+	// queues the permutation for these features into a batch instead of compiling it right away
+	void Add(const ShaderFeatures &features, ShaderBatch &batch);
+	unsigned int Count() const { return (unsigned int)permutations.size(); }
+
+private:
+	std::string vertexPath;
+	std::string fragmentPath;
+	std::map<unsigned int, Shader> permutations;
+};
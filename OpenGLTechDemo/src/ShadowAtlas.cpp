@@ -0,0 +1,154 @@
+#include "ShadowAtlas.h"
+
+#include <iostream>
+
+ShadowAtlas::ShadowAtlas() : size(0), fbo(0), depthTexture(0), usedTexels(0), generation(0)
+{
+}
+
+void ShadowAtlas::Configure(unsigned int requestedSize)
+{
+	unsigned int newSize = MIN_TILE;
+	while (newSize < requestedSize && newSize < MAX_SIZE)
+		newSize *= 2;
+	if (newSize == size)
+		return;
+	size = newSize;
+
+	// initialize if necessary
+	if (fbo == 0) {
+		glGenFramebuffers(1, &fbo);
+		glGenTextures(1, &depthTexture);
+	}
+
+	// every tap of the lit shaders is a hardware 2x2 compare, they keep it inside the tile
+	glBindTexture(GL_TEXTURE_2D, depthTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, size, size, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+	glDrawBuffer(GL_NONE);
+	glReadBuffer(GL_NONE);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "Error::Framebuffer: shadow atlas framebuffer is not complete." << std::endl;
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	Node root = { 0, 0, size, 0, false };
+	nodes.assign(1, root);
+	freeChildren.clear();
+	usedTexels = 0;
+	generation++;
+}
+
+bool ShadowAtlas::Allocate(unsigned int tileSize, ShadowTile &tile)
+{
+	unsigned int rounded = MIN_TILE;
+	while (rounded < tileSize)
+		rounded *= 2;
+
+	// a free node of the size in the nodes already split, only then split a larger free one,
+	// so the large free nodes stay whole for large requests
+	int node = allocate(0, rounded, false);
+	if (node < 0)
+		node = allocate(0, rounded, true);
+	if (node < 0)
+		return false;
+
+	tile.x = nodes[node].x;
+	tile.y = nodes[node].y;
+	tile.size = rounded;
+	usedTexels += rounded * rounded;
+	return true;
+}
+
+int ShadowAtlas::allocate(unsigned int node, unsigned int tileSize, bool split)
+{
+	if (nodes[node].used || nodes[node].size < tileSize)
+		return -1;
+	if (nodes[node].children == 0) {
+		if (nodes[node].size == tileSize) {
+			nodes[node].used = true;
+			return (int)node;
+		}
+		if (!split)
+			return -1;
+
+		unsigned int first;
+		if (!freeChildren.empty()) {
+			first = freeChildren.back();
+			freeChildren.pop_back();
+		} else {
+			first = (unsigned int)nodes.size();
+			nodes.resize(nodes.size() + 4);
+		}
+		unsigned int half = nodes[node].size / 2;
+		for (unsigned int k = 0; k < 4; k++) {
+			Node child = { nodes[node].x + (k & 1) * half, nodes[node].y + (k >> 1) * half, half, 0, false };
+			nodes[first + k] = child;
+		}
+		nodes[node].children = first;
+	}
+
+	for (unsigned int k = 0; k < 4; k++) {
+		int found = allocate(nodes[node].children + k, tileSize, split);
+		if (found >= 0)
+			return found;
+	}
+	return -1;
+}
+
+void ShadowAtlas::Free(ShadowTile &tile)
+{
+	if (!tile.valid())
+		return;
+	if (release(0, tile))
+		usedTexels -= tile.size * tile.size;
+	tile = ShadowTile();
+}
+
+bool ShadowAtlas::release(unsigned int node, const ShadowTile &tile)
+{
+	Node n = nodes[node];
+	if (n.children == 0) {
+		if (!n.used || n.size != tile.size || n.x != tile.x || n.y != tile.y)
+			return false;
+		nodes[node].used = false;
+		return true;
+	}
+
+	unsigned int half = n.size / 2;
+	unsigned int k = (tile.x >= n.x + half ? 1 : 0) + (tile.y >= n.y + half ? 2 : 0);
+	if (!release(n.children + k, tile))
+		return false;
+
+	// merge once all four children are free leaves
+	for (k = 0; k < 4; k++) {
+		const Node &child = nodes[n.children + k];
+		if (child.used || child.children != 0)
+			return true;
+	}
+	freeChildren.push_back(n.children);
+	nodes[node].children = 0;
+	return true;
+}
+
+void ShadowAtlas::Bind() const
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glViewport(0, 0, size, size);
+}
+
+void ShadowAtlas::Clear(const ShadowTile &tile) const
+{
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(tile.x, tile.y, tile.size, tile.size);
+	glClear(GL_DEPTH_BUFFER_BIT);
+	glDisable(GL_SCISSOR_TEST);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <vector>
+
+// square region of the atlas in texels, size 0 is no tile
+struct ShadowTile {
+	unsigned int x;
+	unsigned int y;
+	unsigned int size;
+
+	ShadowTile() : x(0), y(0), size(0) {}
+	bool valid() const { return size != 0; }
+};
+
+// One depth texture shared by the shadows of many lights, so their memory is bounded by its size
+// and the lit shaders read all of them through a single binding. Tiles are handed out by a
+// quadtree: a request of a power of two size takes a free node of that size, splitting larger
+// free nodes on the way down, and a freed node is merged with its siblings once all four are
+// free again. Tiles live until they are freed, so a light keeps its tile and the depth in it
+// from frame to frame.
+// The texture compares in hardware (GL_TEXTURE_COMPARE_MODE) and is sampled as sampler2DShadow.
+class ShadowAtlas {
+public:
+	// smallest tile handed out, in texels
+	static const unsigned int MIN_TILE = 32;
+	static const unsigned int MAX_SIZE = 8192;
+
+	ShadowAtlas();
+	ShadowAtlas(const ShadowAtlas&) = delete;
+	ShadowAtlas& operator=(const ShadowAtlas&) = delete;
+
+	// (re)allocates the depth texture when the size changed, which frees every tile. The size is
+	// rounded up to a power of two between MIN_TILE and MAX_SIZE, the quadtree only splits those.
+	void Configure(unsigned int size);
+	// takes a free tile of size texels (rounded up to a power of two), returns false if none is left
+	bool Allocate(unsigned int size, ShadowTile &tile);
+	void Free(ShadowTile &tile);
+	// binds the atlas as depth target with the whole texture as viewport, geometry is placed in
+	// its tile by the shader
+	void Bind() const;
+	// clears the depth of a tile, the atlas must be bound
+	void Clear(const ShadowTile &tile) const;
+
+	unsigned int Size() const { return size; }
+	unsigned int DepthTexture() const { return depthTexture; }
+	// texels in allocated tiles
+	unsigned int UsedTexels() const { return usedTexels; }
+	// bumped whenever Configure() dropped every tile
+	unsigned int Generation() const { return generation; }
+
+private:
+	struct Node {
+		unsigned int x, y, size;
+		// first of four children, 0 for a leaf
+		unsigned int children;
+		bool used;
+	};
+
+	unsigned int size;
+	unsigned int fbo;
+	unsigned int depthTexture;
+	unsigned int usedTexels;
+	unsigned int generation;
+	// nodes[0] is the root, released children are kept for reuse in freeChildren
+	std::vector<Node> nodes;
+	std::vector<unsigned int> freeChildren;
+
+	// split allows dividing free leaves larger than size
+	int allocate(unsigned int node, unsigned int size, bool split);
+	bool release(unsigned int node, const ShadowTile &tile);
+};
@@ -0,0 +1,184 @@
+#include "ShadowCascades.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "Profiler.h"
+
+namespace {
+	// the projections reach this far towards the light beyond their sphere, so casters outside
+	// the camera frustum still throw shadows into it
+	const float CASTER_MARGIN = 50.0f;
+	// the sphere's center is snapped to steps of 1/SNAP_STEPS of the projection's half size,
+	// which is grown by one step so the snapped projection still holds the whole sphere
+	const unsigned int SNAP_STEPS = 8;
+}
+
+// a step is resolution / (2 * SNAP_STEPS) texels, whole texels for every resolution Configure allows
+static_assert(ShadowCascades::MIN_RESOLUTION % (2 * SNAP_STEPS) == 0, "snap steps must cover whole texels");
+
+ShadowCascades::ShadowCascades()
+	: SplitLambda(0.75f), count(0), resolution(0), fbo(0), depthTexture(0), staticFbo(0), staticTexture(0), splits(0.0f)
+{
+	for (unsigned int i = 0; i < MAX_CASCADES; i++) {
+		matrices[i] = glm::mat4(1.0f);
+		cachedMatrices[i] = glm::mat4(1.0f);
+		cacheValid[i] = false;
+	}
+}
+
+void ShadowCascades::Configure(unsigned int newCount, unsigned int requestedResolution)
+{
+	newCount = std::min(std::max(newCount, 1u), MAX_CASCADES);
+	unsigned int newResolution = MIN_RESOLUTION;
+	while (newResolution < requestedResolution && newResolution < MAX_RESOLUTION)
+		newResolution *= 2;
+	if (newCount == count && newResolution == resolution)
+		return;
+	count = newCount;
+	resolution = newResolution;
+
+	// initialize if necessary
+	if (fbo == 0) {
+		glGenFramebuffers(1, &fbo);
+		glGenTextures(1, &depthTexture);
+		glGenFramebuffers(1, &staticFbo);
+		glGenTextures(1, &staticTexture);
+	}
+
+	allocate(depthTexture, fbo);
+	allocate(staticTexture, staticFbo);
+
+	// the lit shaders sample through sampler2DArrayShadow, every fetch compares against the
+	// reference depth and blends the 2x2 results bilinearly, the cache is only ever blitted
+	glBindTexture(GL_TEXTURE_2D_ARRAY, depthTexture);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	InvalidateCache();
+}
+
+void ShadowCascades::allocate(unsigned int texture, unsigned int framebuffer) const
+{
+	// storage of a texture array can't be resized, so allocate every layer again
+	glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, resolution, resolution, count, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+	float borderColor[] = { 1.0, 1.0, 1.0, 1.0 };
+	glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0, 0);
+	glDrawBuffer(GL_NONE);
+	glReadBuffer(GL_NONE);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "Error::Framebuffer: shadow cascade framebuffer is not complete." << std::endl;
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void ShadowCascades::Update(const glm::mat4 &view, float fovy, float aspect, float nearPlane, float shadowDistance, const glm::vec3 &lightDirection)
+{
+	PROFILE_FUNCTION();
+
+	glm::vec3 direction = glm::normalize(lightDirection);
+	// any up vector works as long as it stays the same from frame to frame, snapping relies on
+	// the rotation of the light view not changing
+	glm::vec3 up = std::abs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+	// rotation only, the cascades move by their projections
+	glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), direction, up);
+	glm::mat4 inverseView = glm::inverse(view);
+	float tanY = std::tan(fovy * 0.5f), tanX = tanY * aspect;
+
+	float front = nearPlane;
+	for (unsigned int i = 0; i < count; i++) {
+		// practical split scheme
+		float t = (float)(i + 1) / count;
+		float logSplit = nearPlane * std::pow(shadowDistance / nearPlane, t);
+		float uniformSplit = nearPlane + (shadowDistance - nearPlane) * t;
+		float back = SplitLambda * logSplit + (1.0f - SplitLambda) * uniformSplit;
+
+		// bounding sphere of the slice between front and back, around the centroid of its corners
+		glm::vec3 corners[8];
+		glm::vec3 center(0.0f);
+		for (unsigned int c = 0; c < 8; c++) {
+			float depth = c < 4 ? front : back;
+			float x = (c & 1) ? tanX : -tanX;
+			float y = (c & 2) ? tanY : -tanY;
+			corners[c] = glm::vec3(inverseView * glm::vec4(x * depth, y * depth, -depth, 1.0f));
+			center += corners[c] / 8.0f;
+		}
+		float radius = 0.0f;
+		for (unsigned int c = 0; c < 8; c++)
+			radius = std::max(radius, glm::length(corners[c] - center));
+		// rounded up, so float noise doesn't change the size from frame to frame
+		radius = std::ceil(radius * 16.0f) / 16.0f;
+
+		// a step is a whole number of texels, so the snapped center also keeps the texel grid
+		// fixed in the world while the sphere follows the camera
+		float halfSize = radius * SNAP_STEPS / (SNAP_STEPS - 1.0f);
+		float step = halfSize / SNAP_STEPS;
+		glm::vec3 lightCenter = glm::vec3(lightView * glm::vec4(center, 1.0f));
+		lightCenter = glm::floor(lightCenter / step + 0.5f) * step;
+
+		// the light looks down -z, casters up to CASTER_MARGIN in front of the sphere are kept
+		glm::mat4 lightProjection = glm::ortho(lightCenter.x - halfSize, lightCenter.x + halfSize, lightCenter.y - halfSize, lightCenter.y + halfSize,
+			-lightCenter.z - halfSize - CASTER_MARGIN, -lightCenter.z + halfSize);
+
+		matrices[i] = lightProjection * lightView;
+		splits[i] = back;
+		front = back;
+	}
+	for (unsigned int i = count; i < MAX_CASCADES; i++) {
+		matrices[i] = matrices[count - 1];
+		splits[i] = shadowDistance;
+	}
+}
+
+void ShadowCascades::BeginCascade(unsigned int cascade) const
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthTexture, 0, cascade);
+	glViewport(0, 0, resolution, resolution);
+	glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+void ShadowCascades::BeginCachedCascade(unsigned int cascade) const
+{
+	// copy the cached layer, the moving casters are depth tested against it
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, staticFbo);
+	glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, staticTexture, 0, cascade);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+	glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthTexture, 0, cascade);
+	glBlitFramebuffer(0, 0, resolution, resolution, 0, 0, resolution, resolution, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glViewport(0, 0, resolution, resolution);
+}
+
+bool ShadowCascades::BeginStaticCascade(unsigned int cascade)
+{
+	if (cacheValid[cascade] && cachedMatrices[cascade] == matrices[cascade])
+		return false;
+	cacheValid[cascade] = true;
+	cachedMatrices[cascade] = matrices[cascade];
+
+	glBindFramebuffer(GL_FRAMEBUFFER, staticFbo);
+	glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, staticTexture, 0, cascade);
+	glViewport(0, 0, resolution, resolution);
+	glClear(GL_DEPTH_BUFFER_BIT);
+	return true;
+}
+
+void ShadowCascades::InvalidateCache()
+{
+	for (unsigned int i = 0; i < MAX_CASCADES; i++)
+		cacheValid[i] = false;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+// Cascaded shadow maps for the directional light. The camera frustum up to the shadow distance is
+// split with the practical split scheme, a blend of logarithmic and uniform split distances, and
+// every slice gets an orthographic light projection around its bounding sphere. The cascades are
+// rendered into the layers of one depth texture array and include/shadows.glsl picks the cascade
+// per fragment from its view depth. The array compares in hardware (GL_TEXTURE_COMPARE_MODE), it
+// is sampled as sampler2DArrayShadow.
+// The sphere keeps the size of a projection constant while the camera turns, and its center is
+// snapped to a grid of whole shadow map texels, so shadow edges don't shimmer when the camera
+// moves. The grid is coarse (1/8 of the cascade), so a cascade's matrix stays exactly the same
+// over many frames of camera movement.
+// That makes the static casters cacheable: they are rendered into a second texture array only
+// when the matrix of a cascade changed or InvalidateCache() was called, and every frame starts
+// from a copy of that depth before the moving casters are drawn.
+class ShadowCascades {
+public:
+	// must match MAX_SHADOW_CASCADES in include/frame.glsl
+	static const unsigned int MAX_CASCADES = 4;
+	// bounds of the per-cascade resolution
+	static const unsigned int MIN_RESOLUTION = 512;
+	static const unsigned int MAX_RESOLUTION = 4096;
+
+	ShadowCascades();
+	ShadowCascades(const ShadowCascades&) = delete;
+	ShadowCascades& operator=(const ShadowCascades&) = delete;
+
+	// (re)allocates the texture array when the count or the resolution changed, the resolution is
+	// rounded up to a power of two between MIN_RESOLUTION and MAX_RESOLUTION
+	void Configure(unsigned int count, unsigned int resolution);
+	// fits the cascades to the frustum of a symmetric perspective camera, lightDirection points
+	// from the light into the scene
+	void Update(const glm::mat4 &view, float fovy, float aspect, float nearPlane, float shadowDistance, const glm::vec3 &lightDirection);
+	// binds the shadow framebuffer with the cascade's layer as depth target, sets the viewport
+	// and clears the layer
+	void BeginCascade(unsigned int cascade) const;
+	// same, but the layer starts as a copy of the cached static casters
+	void BeginCachedCascade(unsigned int cascade) const;
+	// binds and clears the cache layer of the cascade if the static casters have to be drawn
+	// into it again, returns false if the cached depth is still valid
+	bool BeginStaticCascade(unsigned int cascade);
+	// the static casters moved, render every cache layer again
+	void InvalidateCache();
+
+	unsigned int Count() const { return count; }
+	unsigned int Resolution() const { return resolution; }
+	unsigned int DepthTexture() const { return depthTexture; }
+	// light view-projection of every cascade, MAX_CASCADES entries, the unused ones repeat the last
+	const glm::mat4* Matrices() const { return matrices; }
+	// view depth at which every cascade ends, the unused ones at the shadow distance
+	const glm::vec4& Splits() const { return splits; }
+
+	// blend between uniform (0) and logarithmic (1) split distances
+	float SplitLambda;
+
+private:
+	unsigned int count;
+	unsigned int resolution;
+	unsigned int fbo;
+	unsigned int depthTexture;
+	unsigned int staticFbo;
+	unsigned int staticTexture;
+
+	glm::mat4 matrices[MAX_CASCADES];
+	glm::vec4 splits;
+	// matrix every cache layer was rendered with
+	glm::mat4 cachedMatrices[MAX_CASCADES];
+	bool cacheValid[MAX_CASCADES];
+
+	void allocate(unsigned int texture, unsigned int framebuffer) const;
+};
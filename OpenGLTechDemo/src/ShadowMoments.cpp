@@ -0,0 +1,71 @@
+#include "ShadowMoments.h"
+
+#include <algorithm>
+#include <iostream>
+
+ShadowMoments::ShadowMoments() : BlurRadius(2), count(0), resolution(0), fbo(0), momentsTexture(0), blurTexture(0), depthSampler(0)
+{
+}
+
+void ShadowMoments::Configure(unsigned int newCount, unsigned int shadowResolution)
+{
+	unsigned int newResolution = std::min(shadowResolution, MAX_RESOLUTION);
+	if (newCount == count && newResolution == resolution)
+		return;
+	count = newCount;
+	resolution = newResolution;
+
+	// initialize if necessary
+	if (fbo == 0) {
+		glGenFramebuffers(1, &fbo);
+		glGenTextures(1, &momentsTexture);
+		glGenTextures(1, &blurTexture);
+
+		glGenSamplers(1, &depthSampler);
+		glSamplerParameteri(depthSampler, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+		glSamplerParameteri(depthSampler, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glSamplerParameteri(depthSampler, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glSamplerParameteri(depthSampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glSamplerParameteri(depthSampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	}
+
+	// trilinear, the lit shaders pick the mip level from the footprint of the fragment
+	glBindTexture(GL_TEXTURE_2D_ARRAY, momentsTexture);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA32F, resolution, resolution, count, 0, GL_RGBA, GL_FLOAT, nullptr);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+	glBindTexture(GL_TEXTURE_2D_ARRAY, blurTexture);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA32F, resolution, resolution, 1, 0, GL_RGBA, GL_FLOAT, nullptr);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, blurTexture, 0, 0);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "Error::Framebuffer: shadow moments framebuffer is not complete." << std::endl;
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void ShadowMoments::BeginBlur(unsigned int cascade, bool vertical) const
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	if (vertical)
+		glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, momentsTexture, 0, cascade);
+	else
+		glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, blurTexture, 0, 0);
+	glViewport(0, 0, resolution, resolution);
+}
+
+void ShadowMoments::GenerateMipmaps() const
+{
+	glBindTexture(GL_TEXTURE_2D_ARRAY, momentsTexture);
+	glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
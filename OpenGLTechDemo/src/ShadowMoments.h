@@ -0,0 +1,47 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// Exponential variance shadow maps of the directional light's cascades. Every frame the depth of
+// the cascades is warped into four moments, e^(c*d), e^(2c*d), -e^(-c*d) and e^(-2c*d), blurred
+// by a separable Gaussian and mipmapped. The moments filter linearly, so include/shadows.glsl
+// reads a penumbra of any size with a single trilinear fetch and the Chebyshev bound instead of
+// a PCF kernel. The first pass warps the depth and blurs along x into a one layer texture, the
+// second blurs that along y into the cascade's layer of the moments array.
+// The moments are 32 bit floats, the exponents of include/evsm.glsl need the range. They are
+// stored at most at MAX_RESOLUTION, larger cascades are sampled down by the first pass.
+class ShadowMoments {
+public:
+	static const unsigned int MAX_RESOLUTION = 1024;
+
+	ShadowMoments();
+	ShadowMoments(const ShadowMoments&) = delete;
+	ShadowMoments& operator=(const ShadowMoments&) = delete;
+
+	// (re)allocates the moments when the cascade count or the shadow map resolution changed
+	void Configure(unsigned int count, unsigned int shadowResolution);
+	// binds the framebuffer and the viewport of a blur pass, the x pass renders into the blur
+	// texture and the y pass into the cascade's layer of the moments
+	void BeginBlur(unsigned int cascade, bool vertical) const;
+	// builds the mip chain of every layer once all cascades are blurred
+	void GenerateMipmaps() const;
+
+	unsigned int Resolution() const { return resolution; }
+	unsigned int MomentsTexture() const { return momentsTexture; }
+	// single layer array with the x pass's output
+	unsigned int BlurTexture() const { return blurTexture; }
+	// nearest filtering without depth compare, bound over the cascades' compare sampling while
+	// the first pass reads their depth
+	unsigned int DepthSampler() const { return depthSampler; }
+
+	// texels on either side of the Gaussian, 0 turns the blur off
+	int BlurRadius;
+
+private:
+	unsigned int count;
+	unsigned int resolution;
+	unsigned int fbo;
+	unsigned int momentsTexture;
+	unsigned int blurTexture;
+	unsigned int depthSampler;
+};
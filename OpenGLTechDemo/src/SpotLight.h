@@ -1,12 +1,22 @@
 #pragma once
 #include "PointLight.h"
-#include "Shader.h"
+
+// std140 layout of the GLSL SpotLight struct
+struct SpotLightStd140 {
+	PointLightStd140 base;
+	glm::vec3 direction;
+	float cutOff;
+	float outerCutOff;
+	float pad0[3];
+};
+static_assert(sizeof(SpotLightStd140) == 128, "SpotLightStd140 must match the std140 layout of SpotLight");
+
 class SpotLight :
 	public PointLight {
 public:
-	SpotLight(Shader &shader);
+	SpotLight();
 
-	SpotLight(Shader &shader,
+	SpotLight(
 		glm::vec3 color,
 		glm::vec3 ambient, glm::vec3 diffuse, glm::vec3 specular,
 		glm::vec3 position,
@@ -14,16 +24,15 @@ public:
 		float con, float lin, float exp,
 		float edg, float procEdge);
 
-	void UseLight(unsigned int id);
-
 	void SetFlash(glm::vec3 pos, glm::vec3 dir);
 
 	~SpotLight() = default;
 
 private:
+	friend class LightManager;
+
 	glm::vec3 Direction;
 
 	GLfloat Edge, ProcEdge;
 };
 
-
@@ -0,0 +1,6 @@
+#pragma once
+
+// Binding points of the uniform blocks shared between shaders. Shader binds every block it
+// declares to its point after linking, so the buffers are bound once and serve every program.
+#define LIGHTS_BLOCK_BINDING 0
+#define FRAME_BLOCK_BINDING 1
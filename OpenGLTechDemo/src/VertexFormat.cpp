@@ -0,0 +1,72 @@
+#include "VertexFormat.h"
+
+#include <cmath>
+#include <cstddef>
+
+#include "Mesh.h"
+
+static_assert(sizeof(PackedVertex) == 20, "PackedVertex must stay tightly packed");
+
+namespace {
+	VertexFormat fullFormat()
+	{
+		VertexFormat format = { sizeof(Vertex), 5, {
+			{ 0, 3, GL_FLOAT, false, offsetof(Vertex, Position) },
+			{ 1, 3, GL_FLOAT, false, offsetof(Vertex, Normal) },
+			{ 2, 2, GL_FLOAT, false, offsetof(Vertex, TexCoords) },
+			{ 3, 3, GL_FLOAT, false, offsetof(Vertex, Tangent) },
+			{ 4, 3, GL_FLOAT, false, offsetof(Vertex, Bitangent) }
+		} };
+		return format;
+	}
+
+	VertexFormat packedFormat()
+	{
+		// no bitangent, location 4 stays disabled
+		VertexFormat format = { sizeof(PackedVertex), 4, {
+			{ 0, 4, GL_UNSIGNED_SHORT, true, offsetof(PackedVertex, position) },
+			{ 1, 2, GL_SHORT, true, offsetof(PackedVertex, normal) },
+			{ 2, 2, GL_HALF_FLOAT, false, offsetof(PackedVertex, texCoords) },
+			{ 3, 2, GL_SHORT, true, offsetof(PackedVertex, tangent) }
+		} };
+		return format;
+	}
+}
+
+void VertexFormat::Apply() const
+{
+	for (unsigned int i = 0; i < attributeCount; i++) {
+		const VertexAttribute &attribute = attributes[i];
+		glEnableVertexAttribArray(attribute.location);
+		glVertexAttribPointer(attribute.location, attribute.components, attribute.type, attribute.normalized ? GL_TRUE : GL_FALSE, stride, (void*)(size_t)attribute.offset);
+	}
+}
+
+const VertexFormat& VertexFormat::Get(VertexLayout layout)
+{
+	static const VertexFormat full = fullFormat();
+	static const VertexFormat packed = packedFormat();
+	return layout == PackedVertexLayout ? packed : full;
+}
+
+glm::vec2 OctahedronEncode(const glm::vec3 &direction)
+{
+	float length = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+	// degenerate vectors come out as +z
+	if (length == 0.0f)
+		return glm::vec2(0.0f);
+	glm::vec3 n = direction / length;
+	glm::vec2 encoded(n.x, n.y);
+	// the lower half is folded over the diagonals
+	if (n.z < 0.0f) {
+		encoded.x = (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f);
+		encoded.y = (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
+	}
+	return encoded;
+}
+
+int16_t PackSnorm16(float value)
+{
+	float clamped = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+	return (int16_t)std::lround(clamped * 32767.0f);
+}
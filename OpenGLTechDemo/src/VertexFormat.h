@@ -0,0 +1,58 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+// memory layout of a mesh's vertex buffer, picked when the model is loaded
+enum VertexLayout {
+	// struct Vertex as is, 56 bytes of floats
+	FullVertexLayout,
+	// PackedVertex, 20 bytes
+	PackedVertexLayout
+};
+
+// one attribute of an interleaved vertex, as passed to glVertexAttribPointer
+struct VertexAttribute {
+	unsigned int location;
+	int components;
+	GLenum type;
+	bool normalized;
+	unsigned int offset;
+};
+
+// Describes an interleaved vertex so the attribute pointers of a VAO are set up from data instead
+// of by hand.
+struct VertexFormat {
+	static const unsigned int MAX_ATTRIBUTES = 5;
+
+	unsigned int stride;
+	unsigned int attributeCount;
+	VertexAttribute attributes[MAX_ATTRIBUTES];
+
+	// enables and points every attribute at the buffer bound to GL_ARRAY_BUFFER
+	void Apply() const;
+
+	static const VertexFormat& Get(VertexLayout layout);
+};
+
+// Vertex of PackedVertexLayout:
+//   position	unsigned normalized 16 bit per axis between the mesh's bounds, modelShader.vert
+//				scales it back with positionScale and positionOffset. The fourth value is the
+//				sign of the bitangent, 0 or 1.
+//   normal		octahedron encoded, signed normalized 16 bit
+//   texCoords	half floats
+//   tangent	octahedron encoded like the normal, the bitangent is cross(normal, tangent) * sign
+struct PackedVertex {
+	uint16_t position[4];
+	int16_t normal[2];
+	uint16_t texCoords[2];
+	int16_t tangent[2];
+};
+
+// unit vector folded onto the octahedron and unfolded into [-1, 1]^2
+glm::vec2 OctahedronEncode(const glm::vec3 &direction);
+// value of a signed normalized 16 bit component
+int16_t PackSnorm16(float value);